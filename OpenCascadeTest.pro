@@ -1,21 +1,13 @@
-QT += core widgets 3dcore 3drender 3dextras
+QT += core widgets concurrent 3dcore 3drender 3dextras
 
 CONFIG += c++17
 
+include(geo3d.pri)
+
 SOURCES += main.cpp \
-    cylinderobject.cpp \
-    faceobject.cpp \
-    geo3dobject.cpp \
-    geo3dobjectset.cpp \
-    qt3dviewer.cpp \
-    tubeobject.cpp
+    qt3dviewer.cpp
 
 TARGET = qt3d_cylinder_viewer
 
 HEADERS += \
-    cylinderobject.h \
-    faceobject.h \
-    geo3dobject.h \
-    geo3dobjectset.h \
-    qt3dviewer.h \
-    tubeobject.h
+    qt3dviewer.h
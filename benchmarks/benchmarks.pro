@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    churn \
+    compression \
+    edits \
+    frames \
+    model \
+    soak
@@ -0,0 +1,218 @@
+/**
+ * @file tst_churn.cpp
+ * @brief Benchmarks for entity churn, with and without an entity pool
+ *
+ * Two workflows run against a generated site of 5000 objects whose scene
+ * stays up: regenerating a batch of objects (remove, then add equivalent
+ * ones) and paging through the site by removing the page on screen and
+ * adding the next one. Besides the time per cycle, both workflows count
+ * how many Qt3D nodes a cycle creates, with and without a pool, in the same
+ * run; each of them is a backend node created and, in steady state, another
+ * one destroyed. Everything runs without a window.
+ */
+
+#include <QtTest>
+
+#include <Qt3DCore/QEntity>
+
+#include "geo3dentitypool.h"
+#include "geo3dobjectset.h"
+#include "geo3dscenebuilder.h"
+#include "geo3dscenegenerator.h"
+
+static const int s_objectCount = 5000;
+static const int s_batchSize = 500;
+static const int s_measuredCycles = 20;
+
+// Pooled cycles may create at most this share of the nodes fresh ones do
+static const double s_pooledCreationRatio = 0.1;
+
+class tst_Churn : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void nodeCreations_data();
+    void nodeCreations();
+
+    void churn_data();
+    void churn();
+
+private:
+    struct Session;
+
+    // Id the next Qt3D node will get; ids are handed out in construction order
+    static quint64 nextNodeId();
+
+    // Node creations per cycle once warm
+    static double measureCreations(bool paging, bool pooled);
+};
+
+/**
+ * @brief One scene kept up for a run of churn cycles
+ *
+ * All generated objects are kept as JSON so paging can add a page back in
+ * after it was removed. When paging, only the first page is in the set.
+ */
+struct tst_Churn::Session
+{
+    Session(bool paging, bool pooled);
+    ~Session();
+
+    void runCycle();
+    void regenerate();
+    void page();
+
+    // Declared first so the scene releases its bundles before the pool goes
+    Geo3DEntityPool pool;
+    Geo3DObjectSet scene;
+    Qt3DCore::QEntity* root;
+    QStringList names;
+    QHash<QString, QJsonObject> stored;
+    bool paging;
+    int cycle;
+};
+
+tst_Churn::Session::Session(bool paging, bool pooled)
+    : root(nullptr)
+    , paging(paging)
+    , cycle(0)
+{
+    Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(s_objectCount, 20251124));
+    if (pooled) {
+        scene.setEntityPool(&pool);
+    }
+
+    names = scene.getObjectMap().keys();
+    if (paging) {
+        for (int i = s_batchSize; i < names.size(); ++i) {
+            stored.insert(names[i], scene.getObject(names[i])->toJson());
+            scene.removeObject(names[i]);
+        }
+    }
+
+    root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+}
+
+tst_Churn::Session::~Session()
+{
+    scene.releaseEntities();
+    pool.clear();
+    delete root;
+}
+
+void tst_Churn::Session::runCycle()
+{
+    if (paging) {
+        page();
+    } else {
+        regenerate();
+    }
+    ++cycle;
+}
+
+void tst_Churn::Session::regenerate()
+{
+    // Replace one batch with equal objects, as a filter or generator rerun would
+    const int first = (cycle * s_batchSize) % names.size();
+    for (int i = first; i < first + s_batchSize && i < names.size(); ++i) {
+        const QJsonObject json = scene.getObject(names[i])->toJson();
+        scene.addObject(names[i], Geo3DObject::createFromJson(json));
+    }
+    scene.createEntities(root);
+}
+
+void tst_Churn::Session::page()
+{
+    // Take the page on screen out and bring the next one in
+    const int pageCount = names.size() / s_batchSize;
+    const int shown = cycle % pageCount;
+    const int next = (cycle + 1) % pageCount;
+
+    for (int i = 0; i < s_batchSize; ++i) {
+        const QString& name = names[shown * s_batchSize + i];
+        stored.insert(name, scene.getObject(name)->toJson());
+        scene.removeObject(name);
+    }
+    for (int i = 0; i < s_batchSize; ++i) {
+        const QString& name = names[next * s_batchSize + i];
+        scene.addObject(name, Geo3DObject::createFromJson(stored.take(name)));
+    }
+    scene.createEntities(root);
+}
+
+quint64 tst_Churn::nextNodeId()
+{
+    Qt3DCore::QNode probe;
+    return probe.id().id() + 1;
+}
+
+double tst_Churn::measureCreations(bool paging, bool pooled)
+{
+    Session session(paging, pooled);
+
+    // Warm up so the pool and the registries hold a batch worth of nodes
+    for (int i = 0; i < 3; ++i) {
+        session.runCycle();
+    }
+
+    const quint64 firstId = nextNodeId();
+    for (int i = 0; i < s_measuredCycles; ++i) {
+        session.runCycle();
+    }
+    const quint64 created = nextNodeId() - firstId - 1;
+    return double(created) / s_measuredCycles;
+}
+
+void tst_Churn::nodeCreations_data()
+{
+    QTest::addColumn<bool>("paging");
+    QTest::newRow("regenerate") << false;
+    QTest::newRow("page") << true;
+}
+
+void tst_Churn::nodeCreations()
+{
+    QFETCH(bool, paging);
+
+    // Entities, transforms, materials and meshes all count
+    const double fresh = measureCreations(paging, false);
+    const double pooled = measureCreations(paging, true);
+    qInfo().nospace() << QTest::currentDataTag() << ": " << fresh << " node creations per cycle fresh, "
+                      << pooled << " pooled";
+
+    QVERIFY(fresh > 0.0);
+    QVERIFY2(pooled <= fresh * s_pooledCreationRatio,
+             qPrintable(QStringLiteral("Pooled cycles create %1 nodes, fresh ones %2").arg(pooled).arg(fresh)));
+}
+
+void tst_Churn::churn_data()
+{
+    QTest::addColumn<bool>("paging");
+    QTest::addColumn<bool>("pooled");
+    QTest::newRow("regenerate/fresh") << false << false;
+    QTest::newRow("regenerate/pooled") << false << true;
+    QTest::newRow("page/fresh") << true << false;
+    QTest::newRow("page/pooled") << true << true;
+}
+
+void tst_Churn::churn()
+{
+    QFETCH(bool, paging);
+    QFETCH(bool, pooled);
+
+    Session session(paging, pooled);
+
+    // Warm up before timing, as for the node counts
+    for (int i = 0; i < 3; ++i) {
+        session.runCycle();
+    }
+
+    QBENCHMARK {
+        session.runCycle();
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_Churn)
+
+#include "tst_churn.moc"
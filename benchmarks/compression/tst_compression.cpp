@@ -0,0 +1,119 @@
+/**
+ * @file tst_compression.cpp
+ * @brief Compares CompressedFormat scene files against the plain JSON from saveToFile
+ *
+ * Reports the compression ratio once, then benchmarks end-to-end loading
+ * (read, decompress, parse, create objects) of both files.
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QFileInfo>
+
+#include "geo3dobjectset.h"
+#include "cylinderobject.h"
+#include "faceobject.h"
+
+class tst_Compression : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void saveJson();
+    void saveCompressed();
+    void loadJson();
+    void loadCompressed();
+
+private:
+    void populate(Geo3DObjectSet& scene) const;
+
+    QTemporaryDir m_dir;
+    QString m_jsonPath;
+    QString m_compressedPath;
+    Geo3DObjectSet m_scene;
+};
+
+void tst_Compression::populate(Geo3DObjectSet& scene) const
+{
+    // Fixed seed so every run measures the same scene
+    QRandomGenerator random(20251120);
+
+    for (int i = 0; i < 2000; ++i) {
+        CylinderObject* cylinder = new CylinderObject(0.5f + random.bounded(1.0), 2.0f + random.bounded(20.0));
+        cylinder->setPosition(random.bounded(1000.0), -random.bounded(50.0), random.bounded(1000.0));
+        scene.addObject(QStringLiteral("borehole_%1").arg(i), cylinder);
+    }
+
+    // Faces carry the large vertex payloads
+    for (int i = 0; i < 500; ++i) {
+        QVector<QVector2D> vertices;
+        vertices.reserve(512);
+        for (int v = 0; v < 512; ++v) {
+            const float angle = 2.0f * float(M_PI) * v / 512;
+            const float radius = 50.0f + float(random.bounded(5.0));
+            vertices.append(QVector2D(radius * qCos(angle), radius * qSin(angle)));
+        }
+        FaceObject* face = new FaceObject(vertices, -float(i) * 0.1f);
+        scene.addObject(QStringLiteral("horizon_%1").arg(i), face);
+    }
+}
+
+void tst_Compression::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_jsonPath = m_dir.filePath(QStringLiteral("scene.json"));
+    m_compressedPath = m_dir.filePath(QStringLiteral("scene.g3dz"));
+
+    populate(m_scene);
+    QVERIFY(m_scene.saveToFile(m_jsonPath, Geo3DObjectSet::JsonFormat));
+    QVERIFY(m_scene.saveToFile(m_compressedPath, Geo3DObjectSet::CompressedFormat));
+
+    const qint64 jsonSize = QFileInfo(m_jsonPath).size();
+    const qint64 compressedSize = QFileInfo(m_compressedPath).size();
+    QVERIFY(compressedSize > 0);
+
+    qInfo().noquote() << QStringLiteral("JSON: %1 bytes, compressed: %2 bytes, ratio %3:1")
+                             .arg(jsonSize)
+                             .arg(compressedSize)
+                             .arg(double(jsonSize) / double(compressedSize), 0, 'f', 2);
+}
+
+void tst_Compression::saveJson()
+{
+    QBENCHMARK {
+        QVERIFY(m_scene.saveToFile(m_jsonPath, Geo3DObjectSet::JsonFormat));
+    }
+}
+
+void tst_Compression::saveCompressed()
+{
+    QBENCHMARK {
+        QVERIFY(m_scene.saveToFile(m_compressedPath, Geo3DObjectSet::CompressedFormat));
+    }
+}
+
+void tst_Compression::loadJson()
+{
+    Geo3DObjectSet loaded;
+    QBENCHMARK {
+        QVERIFY(loaded.loadFromFile(m_jsonPath));
+    }
+    QCOMPARE(loaded.count(), m_scene.count());
+}
+
+void tst_Compression::loadCompressed()
+{
+    Geo3DObjectSet loaded;
+    QBENCHMARK {
+        QVERIFY(loaded.loadFromFile(m_compressedPath));
+    }
+    QCOMPARE(loaded.count(), m_scene.count());
+    QCOMPARE(loaded.toJson(), m_scene.toJson());
+}
+
+QTEST_GUILESS_MAIN(tst_Compression)
+
+#include "tst_compression.moc"
@@ -0,0 +1,11 @@
+QT += testlib
+QT -= gui widgets
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include(../../geo3d.pri)
+
+TARGET = tst_edits
+
+SOURCES += tst_edits.cpp
@@ -0,0 +1,192 @@
+/**
+ * @file tst_edits.cpp
+ * @brief Counts the Qt3D updates of bulk edits, with and without an edit transaction
+ *
+ * A scene of 50000 cylinders is recoloured and moved, once with every setter
+ * pushing to Qt3D on its own and once inside a Geo3DObjectSet::EditTransaction.
+ * Moves count the matrixChanged notifications of the object transforms;
+ * recolours count the Qt3D nodes created for new materials, since shared
+ * materials are swapped rather than changed in place. Unused materials are
+ * kept while counting, so every node created stays in the scene tree.
+ * Everything runs without a window.
+ */
+
+#include <QtTest>
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DCore/QTransform>
+#include <functional>
+
+#include "geo3dobjectset.h"
+#include "geo3dscenebuilder.h"
+#include "cylinderobject.h"
+
+static const int s_objectCount = 50000;
+
+class tst_Edits : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void moveNotifications();
+    void recolourNodeCreations();
+
+    void recolour_data();
+    void recolour();
+
+private:
+    static void populate(Geo3DObjectSet& scene);
+
+    // Colours are distinct per object and pass, so no two steps share a material
+    static void recolourAll(Geo3DObjectSet& scene, int pass);
+    static void moveAll(Geo3DObjectSet& scene, int pass);
+
+    // Number of matrixChanged notifications while running an edit
+    static int countMatrixChanges(Geo3DObjectSet& scene, const std::function<void()>& edit);
+
+    // Number of Qt3D nodes added below the scene root while running an edit
+    static int countNodeCreations(Qt3DCore::QNode* root, const std::function<void()>& edit);
+};
+
+void tst_Edits::populate(Geo3DObjectSet& scene)
+{
+    for (int i = 0; i < s_objectCount; ++i) {
+        CylinderObject* cylinder = new CylinderObject(0.5f, 10.0f);
+        cylinder->setPosition(float(i % 250) * 4.0f, 0.0f, float(i / 250) * 4.0f);
+        scene.addObject(QStringLiteral("well_%1").arg(i), cylinder);
+    }
+}
+
+void tst_Edits::recolourAll(Geo3DObjectSet& scene, int pass)
+{
+    int i = 0;
+    for (auto it = scene.constBegin(); it != scene.constEnd(); ++it, ++i) {
+        const QColor diffuse(i % 256, (i / 256) % 256, (pass * 40) % 256);
+        it.value()->setDiffuseColor(diffuse);
+        it.value()->setAmbientColor(diffuse.darker());
+        it.value()->setSpecularColor(QColor(255, (pass * 40) % 256, i % 256));
+    }
+}
+
+void tst_Edits::moveAll(Geo3DObjectSet& scene, int pass)
+{
+    for (auto it = scene.constBegin(); it != scene.constEnd(); ++it) {
+        Geo3DObject* object = it.value();
+        object->setPosition(object->getPosition() + QVector3D(0.0f, 1.0f, 0.0f));
+        object->setRotation(0.0f, float(pass * 15 % 360), 0.0f);
+        object->setScale(1.0f + 0.1f * (pass % 5 + 1));
+    }
+}
+
+int tst_Edits::countMatrixChanges(Geo3DObjectSet& scene, const std::function<void()>& edit)
+{
+    int changes = 0;
+    QVector<QMetaObject::Connection> connections;
+    connections.reserve(scene.count());
+    for (auto it = scene.constBegin(); it != scene.constEnd(); ++it) {
+        const QVector<Qt3DCore::QTransform*> transforms =
+            it.value()->getEntity()->componentsOfType<Qt3DCore::QTransform>();
+        for (Qt3DCore::QTransform* transform : transforms) {
+            connections.append(connect(transform, &Qt3DCore::QTransform::matrixChanged, [&changes]() { ++changes; }));
+        }
+    }
+
+    edit();
+
+    for (const QMetaObject::Connection& connection : std::as_const(connections)) {
+        disconnect(connection);
+    }
+    return changes;
+}
+
+int tst_Edits::countNodeCreations(Qt3DCore::QNode* root, const std::function<void()>& edit)
+{
+    const int before = root->findChildren<Qt3DCore::QNode*>().size();
+    edit();
+    return root->findChildren<Qt3DCore::QNode*>().size() - before;
+}
+
+void tst_Edits::moveNotifications()
+{
+    Geo3DObjectSet scene;
+    populate(scene);
+    Qt3DCore::QEntity* root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+
+    // Position, rotation and scale each push the whole matrix
+    const int single = countMatrixChanges(scene, [&scene]() { moveAll(scene, 1); });
+    int pending = 0;
+    const int batched = countMatrixChanges(scene, [&scene, &pending]() {
+        Geo3DObjectSet::EditTransaction edit(scene);
+        moveAll(scene, 2);
+        pending = scene.pendingUpdateCount();
+    });
+    qInfo() << "Move of" << s_objectCount << "objects:" << single << "matrix notifications without a transaction,"
+            << batched << "with";
+
+    QCOMPARE(pending, s_objectCount);
+    QCOMPARE(single, 3 * s_objectCount);
+    QCOMPARE(batched, s_objectCount);
+
+    scene.releaseEntities();
+    delete root;
+}
+
+void tst_Edits::recolourNodeCreations()
+{
+    Geo3DObjectSet scene;
+    populate(scene);
+    Qt3DCore::QEntity* root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+
+    // Each setter interns another combination; a transaction only the final one
+    scene.getMaterialRegistry()->setKeepUnused(true);
+    const int single = countNodeCreations(root, [&scene]() { recolourAll(scene, 1); });
+    const int batched = countNodeCreations(root, [&scene]() {
+        Geo3DObjectSet::EditTransaction edit(scene);
+        recolourAll(scene, 2);
+    });
+    qInfo() << "Recolour of" << s_objectCount << "objects:" << single << "nodes created without a transaction,"
+            << batched << "with";
+
+    QVERIFY(batched > 0);
+    QCOMPARE(single, 3 * batched);
+
+    // Only the materials of the last pass are still in use
+    scene.getMaterialRegistry()->setKeepUnused(false);
+    QCOMPARE(scene.materialCount(), s_objectCount);
+
+    scene.releaseEntities();
+    delete root;
+}
+
+void tst_Edits::recolour_data()
+{
+    QTest::addColumn<bool>("transaction");
+    QTest::newRow("single") << false;
+    QTest::newRow("transaction") << true;
+}
+
+void tst_Edits::recolour()
+{
+    QFETCH(bool, transaction);
+
+    Geo3DObjectSet scene;
+    populate(scene);
+    Qt3DCore::QEntity* root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+
+    int pass = 0;
+    QBENCHMARK {
+        if (transaction) {
+            Geo3DObjectSet::EditTransaction edit(scene);
+            recolourAll(scene, ++pass);
+        } else {
+            recolourAll(scene, ++pass);
+        }
+    }
+
+    scene.releaseEntities();
+    delete root;
+}
+
+QTEST_GUILESS_MAIN(tst_Edits)
+
+#include "tst_edits.moc"
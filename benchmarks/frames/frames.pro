@@ -0,0 +1,10 @@
+QT -= widgets
+
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../../geo3d.pri)
+
+TARGET = bench_frames
+
+SOURCES += main.cpp
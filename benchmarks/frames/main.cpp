@@ -0,0 +1,184 @@
+/**
+ * @file main.cpp
+ * @brief Offscreen frame-time benchmark for the Qt3D scene
+ *
+ * Builds a site model with Geo3DSceneGenerator, creates the same framegraph and entity
+ * tree as Qt3DViewer through Geo3DSceneBuilder, renders a number of frames
+ * without a display and prints the measurements as one JSON object:
+ *
+ * @code
+ * {"objects": 10000, "entities": 10003, "sceneBuildMs": 812.4,
+ *  "timeToFirstFrameMs": 1530.2, "frames": 300, "frameTimeMeanMs": 21.7,
+ *  "frameTimeP95Ms": 25.1, "frameTimeP99Ms": 31.0, "platform": "offscreen"}
+ * @endcode
+ *
+ * With --camera-path, a path recorded in the viewer is replayed one keyframe
+ * per frame instead, so every build renders exactly the same views.
+ *
+ * Unless the environment says otherwise, the offscreen platform plugin and
+ * Mesa's software rasterizer are used, so no GPU is needed. On systems whose
+ * offscreen plugin has no OpenGL support, run it under xvfb-run with
+ * QT_QPA_PLATFORM=xcb instead.
+ */
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QFile>
+#include <QTimer>
+#include <QDebug>
+
+#include <Qt3DExtras/Qt3DWindow>
+#include <Qt3DCore/QEntity>
+#include <Qt3DLogic/QFrameAction>
+#include <Qt3DRender/QFrustumCulling>
+#include <Qt3DRender/QLayerFilter>
+#include <Qt3DRender/QRenderCapture>
+#include <Qt3DRender/QRenderSurfaceSelector>
+
+#include "geo3dobjectset.h"
+#include "geo3dcamerapath.h"
+#include "geo3dscenebuilder.h"
+#include "geo3dscenegenerator.h"
+
+// Gives up when the first frame never arrives, e.g. without a usable OpenGL implementation
+static const int s_firstFrameTimeoutMs = 120000;
+
+// Gives up when rendering stalls after the first frame
+static const int s_frameTimeoutMs = 30000;
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    if (qEnvironmentVariableIsEmpty("LIBGL_ALWAYS_SOFTWARE")) {
+        qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+    }
+    QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
+
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders a generated scene offscreen and reports frame times as JSON.");
+    parser.addHelpOption();
+    QCommandLineOption objectsOption("objects", "Number of objects in the scene.", "count", "10000");
+    QCommandLineOption framesOption("frames", "Number of frames to time after the first one.", "count", "300");
+    QCommandLineOption seedOption("seed", "Seed of the scene generator.", "seed", "20251122");
+    QCommandLineOption cameraPathOption("camera-path",
+                                        "Replay a recorded camera path instead of timing a fixed view.", "file");
+    QCommandLineOption timingsOption("frame-timings", "Also write every frame time to a JSON file.", "file");
+    QCommandLineOption outputOption("output", "Write the JSON report to a file instead of stdout.", "file");
+    parser.addOptions({objectsOption, framesOption, seedOption, cameraPathOption, timingsOption, outputOption});
+    parser.process(app);
+
+    const int objectCount = qMax(1, parser.value(objectsOption).toInt());
+    const int frameCount = qMax(1, parser.value(framesOption).toInt());
+    const QString outputPath = parser.value(outputOption);
+
+    Geo3DCameraPath cameraPath;
+    if (parser.isSet(cameraPathOption) && !cameraPath.loadFromFile(parser.value(cameraPathOption))) {
+        return 1;
+    }
+
+    Geo3DObjectSet scene;
+    Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(
+                                             objectCount, parser.value(seedOption).toUInt()));
+
+    Qt3DExtras::Qt3DWindow view;
+    view.resize(1280, 720);
+
+    Qt3DRender::QLayerFilter* layerFilter = nullptr;
+    Qt3DRender::QRenderSurfaceSelector* frameGraph = Geo3DSceneBuilder::createFrameGraph(&view, view.camera(), &layerFilter);
+
+    // Captures complete once a frame has actually been rendered
+    Qt3DRender::QRenderCapture* capture =
+        new Qt3DRender::QRenderCapture(layerFilter->findChild<Qt3DRender::QFrustumCulling*>());
+    view.setActiveFrameGraph(frameGraph);
+
+    QElapsedTimer clock;
+    clock.start();
+
+    Qt3DCore::QEntity* rootEntity = Geo3DSceneBuilder::createScene(&scene, layerFilter, view.camera());
+    const double sceneBuildMs = clock.nsecsElapsed() / 1.0e6;
+    const int entityCount = rootEntity->findChildren<Qt3DCore::QEntity*>().size() + 1;
+
+    // Without a recorded path, hold the framed view for the requested number of frames
+    if (cameraPath.isEmpty()) {
+        const Geo3DCameraPath::Keyframe pose = Geo3DCameraPath::capture(view.camera(), 0);
+        for (int frame = 0; frame < frameCount; ++frame) {
+            cameraPath.append(pose);
+        }
+    }
+
+    Geo3DCameraRecorder recorder(rootEntity, view.camera());
+    QObject::connect(&recorder, &Geo3DCameraRecorder::replayFinished, &app, &QCoreApplication::quit);
+
+    view.setRootEntity(rootEntity);
+    view.show();
+
+    double timeToFirstFrameMs = -1.0;
+
+    QTimer watchdog;
+    watchdog.setSingleShot(true);
+    QObject::connect(&watchdog, &QTimer::timeout, &app, [&]() {
+        if (timeToFirstFrameMs < 0.0) {
+            qWarning() << "No frame rendered within" << s_firstFrameTimeoutMs / 1000
+                       << "s; is an OpenGL implementation available for platform" << QGuiApplication::platformName() << "?";
+        } else {
+            qWarning() << "Rendering stalled for" << s_frameTimeoutMs / 1000 << "s after"
+                       << recorder.frameTimes().size() << "frames";
+        }
+        app.exit(1);
+    });
+    watchdog.start(s_firstFrameTimeoutMs);
+
+    // Re-armed every frame once the first one is in, so a stall later on cannot hang the run either
+    Qt3DLogic::QFrameAction* frameTick = new Qt3DLogic::QFrameAction();
+    rootEntity->addComponent(frameTick);
+    QObject::connect(frameTick, &Qt3DLogic::QFrameAction::triggered, &app, [&]() {
+        if (timeToFirstFrameMs >= 0.0) {
+            watchdog.start(s_frameTimeoutMs);
+        }
+    });
+
+    Qt3DRender::QRenderCaptureReply* firstFrame = capture->requestCapture();
+    QObject::connect(firstFrame, &Qt3DRender::QRenderCaptureReply::completed, &app, [&]() {
+        timeToFirstFrameMs = clock.nsecsElapsed() / 1.0e6;
+        watchdog.start(s_frameTimeoutMs);
+        firstFrame->deleteLater();
+        recorder.startReplay(cameraPath);
+    });
+
+    if (app.exec() != 0) {
+        return 1;
+    }
+
+    const QVector<double> frameTimes = recorder.frameTimes();
+    if (parser.isSet(timingsOption) && !Geo3DCameraRecorder::saveFrameTimes(parser.value(timingsOption), frameTimes)) {
+        return 1;
+    }
+
+    QJsonObject report = Geo3DCameraRecorder::summarizeFrameTimes(frameTimes);
+    report["objects"] = objectCount;
+    report["entities"] = entityCount;
+    report["sceneBuildMs"] = sceneBuildMs;
+    report["timeToFirstFrameMs"] = timeToFirstFrameMs;
+    report["platform"] = QGuiApplication::platformName();
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Compact) + '\n';
+    if (outputPath.isEmpty()) {
+        QTextStream(stdout) << json;
+        return 0;
+    }
+
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly) || output.write(json) != json.size()) {
+        qWarning() << "Could not write report:" << outputPath;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,512 @@
+/**
+ * @file tst_model.cpp
+ * @brief Benchmarks for the scene model: geometry, serialization and scene queries
+ *
+ * Covers tube tessellation, face triangulation (timing, plus area and
+ * winding checks on concave and clockwise outlines), in-memory and on-disk JSON
+ * round trips at 1k, 10k and 100k objects, the world-space bounds used
+ * to place the viewer camera, the per-type memory report on meshes of
+ * known size, in-place hot reloads of a changed scene file, and saves of
+ * partially loaded containers. Everything runs without a window.
+ */
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DRender/QGeometryRenderer>
+
+#include "geo3dobjectset.h"
+#include "geo3dscenegenerator.h"
+#include "tubeobject.h"
+#include "faceobject.h"
+#include "cylinderobject.h"
+
+// Exposes the protected factory so the benchmark measures exactly what entities use
+class BenchmarkTube : public TubeObject
+{
+public:
+    using TubeObject::TubeObject;
+    using TubeObject::createGeometry;
+};
+
+class tst_Model : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void tubeCreateGeometry_data();
+    void tubeCreateGeometry();
+
+    void faceTriangulate_data();
+    void faceTriangulate();
+
+    void faceTriangulateShapes_data();
+    void faceTriangulateShapes();
+
+    void sceneToJson_data();
+    void sceneToJson();
+
+    void sceneFromJson_data();
+    void sceneFromJson();
+
+    void sceneSaveToFile_data();
+    void sceneSaveToFile();
+
+    void sceneLoadFromFile_data();
+    void sceneLoadFromFile();
+
+    void sceneBounds_data();
+    void sceneBounds();
+
+    void memoryReport();
+
+    void sceneReloadFromFile();
+    void renderModesRoundTrip();
+    void partialLoadSave();
+
+private:
+    void addSceneSizes();
+    static void populate(Geo3DObjectSet& scene, int objectCount);
+    static QVector<QVector2D> polygon(int vertexCount);
+    static QVector<QVector2D> star(int pointCount);
+    static QVector<QVector2D> comb(int toothCount);
+    static QVector<QVector2D> reversed(const QVector<QVector2D>& outline);
+    static double signedArea(const QVector<QVector2D>& outline);
+
+    QTemporaryDir m_dir;
+};
+
+void tst_Model::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void tst_Model::addSceneSizes()
+{
+    QTest::addColumn<int>("objectCount");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void tst_Model::populate(Geo3DObjectSet& scene, int objectCount)
+{
+    // Built like the frame and soak scenes; fixed seed so every run measures the same one
+    Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(objectCount, 20251121));
+}
+
+QVector<QVector2D> tst_Model::polygon(int vertexCount)
+{
+    QVector<QVector2D> vertices;
+    vertices.reserve(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) {
+        const float angle = 2.0f * float(M_PI) * v / vertexCount;
+        vertices.append(QVector2D(10.0f * qCos(angle), 10.0f * qSin(angle)));
+    }
+    return vertices;
+}
+
+QVector<QVector2D> tst_Model::star(int pointCount)
+{
+    // Alternating outer and inner radius; every inner vertex is a reflex corner
+    QVector<QVector2D> vertices;
+    vertices.reserve(2 * pointCount);
+    for (int v = 0; v < 2 * pointCount; ++v) {
+        const float angle = float(M_PI) * v / pointCount;
+        const float radius = (v % 2 == 0) ? 10.0f : 4.0f;
+        vertices.append(QVector2D(radius * qCos(angle), radius * qSin(angle)));
+    }
+    return vertices;
+}
+
+QVector<QVector2D> tst_Model::comb(int toothCount)
+{
+    // Counter-clockwise: along the base, then over each tooth from right to left
+    QVector<QVector2D> vertices;
+    vertices.append(QVector2D(0.0f, 0.0f));
+    vertices.append(QVector2D(2.0f * toothCount - 1.0f, 0.0f));
+    for (int t = toothCount - 1; t >= 0; --t) {
+        vertices.append(QVector2D(2.0f * t + 1.0f, 5.0f));
+        vertices.append(QVector2D(2.0f * t, 5.0f));
+        if (t > 0) {
+            // Bottom of the gap to the next tooth
+            vertices.append(QVector2D(2.0f * t, 1.0f));
+            vertices.append(QVector2D(2.0f * t - 1.0f, 1.0f));
+        }
+    }
+    return vertices;
+}
+
+QVector<QVector2D> tst_Model::reversed(const QVector<QVector2D>& outline)
+{
+    return QVector<QVector2D>(outline.crbegin(), outline.crend());
+}
+
+double tst_Model::signedArea(const QVector<QVector2D>& outline)
+{
+    // Shoelace formula; positive when counter-clockwise
+    double area = 0.0;
+    for (int i = 0; i < outline.size(); ++i) {
+        const QVector2D& a = outline[i];
+        const QVector2D& b = outline[(i + 1) % outline.size()];
+        area += double(a.x()) * b.y() - double(b.x()) * a.y();
+    }
+    return area / 2.0;
+}
+
+void tst_Model::tubeCreateGeometry_data()
+{
+    QTest::addColumn<int>("rings");
+    QTest::addColumn<int>("slices");
+    QTest::newRow("1x16") << 1 << 16;
+    QTest::newRow("4x32") << 4 << 32;
+    QTest::newRow("20x48") << 20 << 48;
+    QTest::newRow("64x128") << 64 << 128;
+    QTest::newRow("128x256") << 128 << 256;
+}
+
+void tst_Model::tubeCreateGeometry()
+{
+    QFETCH(int, rings);
+    QFETCH(int, slices);
+
+    BenchmarkTube tube(1.0f, 12.0f, 7.0f, rings, slices);
+    QBENCHMARK {
+        Qt3DRender::QGeometryRenderer* renderer = tube.createGeometry();
+        QVERIFY(renderer);
+        delete renderer;
+    }
+}
+
+void tst_Model::faceTriangulate_data()
+{
+    QTest::addColumn<int>("vertexCount");
+    QTest::newRow("8") << 8;
+    QTest::newRow("64") << 64;
+    QTest::newRow("512") << 512;
+    QTest::newRow("4096") << 4096;
+}
+
+void tst_Model::faceTriangulate()
+{
+    QFETCH(int, vertexCount);
+
+    FaceObject face(polygon(vertexCount), 0.0f);
+    QVector<unsigned int> indices;
+    QBENCHMARK {
+        indices = face.triangulate();
+    }
+    QCOMPARE(indices.size(), (vertexCount - 2) * 3);
+}
+
+void tst_Model::faceTriangulateShapes_data()
+{
+    QTest::addColumn<QVector<QVector2D>>("outline");
+    QTest::newRow("convex") << polygon(64);
+    QTest::newRow("convex/clockwise") << reversed(polygon(64));
+    QTest::newRow("star") << star(12);
+    QTest::newRow("star/clockwise") << reversed(star(12));
+    QTest::newRow("comb") << comb(8);
+    QTest::newRow("comb/clockwise") << reversed(comb(8));
+}
+
+void tst_Model::faceTriangulateShapes()
+{
+    QFETCH(QVector<QVector2D>, outline);
+
+    FaceObject face(outline, 0.0f);
+    const QVector<unsigned int> indices = face.triangulate();
+    QCOMPARE(indices.size(), (outline.size() - 2) * 3);
+
+    // The triangles tile the outline exactly when none overlaps or is inverted
+    const double outlineArea = signedArea(outline);
+    double triangleArea = 0.0;
+    for (int i = 0; i < indices.size(); i += 3) {
+        QVERIFY(int(indices[i]) < outline.size() && int(indices[i + 1]) < outline.size()
+                && int(indices[i + 2]) < outline.size());
+        const double area = signedArea({outline[indices[i]], outline[indices[i + 1]], outline[indices[i + 2]]});
+        QVERIFY2(area * outlineArea > 0.0, qPrintable(QStringLiteral("Triangle %1 is inverted or degenerate").arg(i / 3)));
+        triangleArea += area;
+    }
+    QVERIFY(qAbs(triangleArea - outlineArea) <= 1.0e-4 * qAbs(outlineArea));
+}
+
+void tst_Model::sceneToJson_data()
+{
+    addSceneSizes();
+}
+
+void tst_Model::sceneToJson()
+{
+    QFETCH(int, objectCount);
+
+    Geo3DObjectSet scene;
+    populate(scene, objectCount);
+
+    QJsonObject json;
+    QBENCHMARK {
+        json = scene.toJson();
+    }
+    QVERIFY(!json.isEmpty());
+}
+
+void tst_Model::sceneFromJson_data()
+{
+    addSceneSizes();
+}
+
+void tst_Model::sceneFromJson()
+{
+    QFETCH(int, objectCount);
+
+    Geo3DObjectSet scene;
+    populate(scene, objectCount);
+    const QJsonObject json = scene.toJson();
+
+    Geo3DObjectSet loaded;
+    QBENCHMARK {
+        QVERIFY(loaded.fromJson(json));
+    }
+    QCOMPARE(loaded.count(), objectCount);
+}
+
+void tst_Model::sceneSaveToFile_data()
+{
+    addSceneSizes();
+}
+
+void tst_Model::sceneSaveToFile()
+{
+    QFETCH(int, objectCount);
+
+    Geo3DObjectSet scene;
+    populate(scene, objectCount);
+    const QString path = m_dir.filePath(QStringLiteral("save_%1.json").arg(objectCount));
+
+    QBENCHMARK {
+        QVERIFY(scene.saveToFile(path));
+    }
+}
+
+void tst_Model::sceneLoadFromFile_data()
+{
+    addSceneSizes();
+}
+
+void tst_Model::sceneLoadFromFile()
+{
+    QFETCH(int, objectCount);
+
+    const QString path = m_dir.filePath(QStringLiteral("load_%1.json").arg(objectCount));
+    {
+        Geo3DObjectSet scene;
+        populate(scene, objectCount);
+        QVERIFY(scene.saveToFile(path));
+    }
+
+    Geo3DObjectSet loaded;
+    QBENCHMARK {
+        QVERIFY(loaded.loadFromFile(path));
+    }
+    QCOMPARE(loaded.count(), objectCount);
+}
+
+void tst_Model::sceneBounds_data()
+{
+    addSceneSizes();
+}
+
+void tst_Model::sceneBounds()
+{
+    QFETCH(int, objectCount);
+
+    Geo3DObjectSet scene;
+    populate(scene, objectCount);
+
+    QVector3D minimum;
+    QVector3D maximum;
+    QBENCHMARK {
+        QVERIFY(scene.calculateBounds(minimum, maximum));
+    }
+    QVERIFY(minimum.x() <= maximum.x());
+}
+
+void tst_Model::memoryReport()
+{
+    // Faces hold positions only, tubes interleave positions and normals; indices are 32-bit
+    const int faceVertices = 8;
+    const qint64 faceMeshBytes = faceVertices * 3 * qint64(sizeof(float))
+        + (faceVertices - 2) * 3 * qint64(sizeof(quint32));
+    const int rings = 4;
+    const int slices = 32;
+    const qint64 tubeVertices = (rings + 1) * (slices + 1) * 2 + (slices + 1) * 4;
+    const qint64 tubeTriangles = 4 * slices * rings + 4 * slices;
+    const qint64 tubeMeshBytes = tubeVertices * 6 * qint64(sizeof(float)) + tubeTriangles * 3 * qint64(sizeof(quint32));
+
+    // Two face shapes, one of them used twice, and one tube
+    Geo3DObjectSet scene;
+    scene.addObject(QStringLiteral("face_0"), new FaceObject(polygon(faceVertices), 0.0f));
+    scene.addObject(QStringLiteral("face_1"), new FaceObject(polygon(faceVertices), 5.0f));
+    scene.addObject(QStringLiteral("face_2"), new FaceObject(polygon(faceVertices), 0.0f));
+    scene.addObject(QStringLiteral("tube_0"), new TubeObject(1.0f, 12.0f, 7.0f, rings, slices));
+
+    // Before the scene exists there are no meshes to count
+    Geo3DObjectSet::MemoryReport report = scene.memoryReport();
+    QCOMPARE(report.types.value(QStringLiteral("Face")).meshBufferBytes, qint64(0));
+
+    Qt3DCore::QEntity* root = new Qt3DCore::QEntity();
+    scene.createEntities(root);
+    report = scene.memoryReport();
+
+    const Geo3DObjectSet::MemoryReport::TypeUsage faces = report.types.value(QStringLiteral("Face"));
+    QCOMPARE(faces.objects, 3);
+    QCOMPARE(faces.meshes, 2);
+    QCOMPARE(faces.meshBufferBytes, 2 * faceMeshBytes);
+    QVERIFY(faces.vertexArrayBytes >= 3 * faceVertices * qint64(sizeof(QVector2D)));
+
+    const Geo3DObjectSet::MemoryReport::TypeUsage tubes = report.types.value(QStringLiteral("Tube"));
+    QCOMPARE(tubes.objects, 1);
+    QCOMPARE(tubes.meshes, 1);
+    QCOMPARE(tubes.meshBufferBytes, tubeMeshBytes);
+    QCOMPARE(tubes.vertexArrayBytes, qint64(0));
+
+    QCOMPARE(report.types.size(), 2);
+    QVERIFY(report.totalBytes() >= 2 * faceMeshBytes + tubeMeshBytes);
+
+    scene.releaseEntities();
+    delete root;
+}
+
+void tst_Model::sceneReloadFromFile()
+{
+    const QString path = m_dir.filePath(QStringLiteral("reload.json"));
+    {
+        Geo3DObjectSet original;
+        original.addObject(QStringLiteral("face"), new FaceObject(polygon(6), 0.0f));
+        original.addObject(QStringLiteral("tube"), new TubeObject(1.0f, 2.0f, 5.0f));
+        original.addObject(QStringLiteral("well"), new CylinderObject(0.5f, 10.0f));
+        original.addObject(QStringLiteral("gone"), new CylinderObject(0.5f, 10.0f));
+        QVERIFY(original.saveToFile(path));
+    }
+
+    Geo3DObjectSet live;
+    QVERIFY(live.loadFromFile(path));
+    QVERIFY(!live.hasUnsavedChanges());
+    Qt3DCore::QEntity* root = new Qt3DCore::QEntity();
+    live.createEntities(root);
+    Geo3DObject* face = live.getObject(QStringLiteral("face"));
+
+    // One object of each kind of change, plus one left alone
+    {
+        Geo3DObjectSet edited;
+        edited.addObject(QStringLiteral("face"), new FaceObject(polygon(8), 0.0f));
+        edited.addObject(QStringLiteral("tube"), new TubeObject(1.0f, 2.0f, 5.0f));
+        edited.addObject(QStringLiteral("well"), new TubeObject(0.25f, 0.5f, 10.0f));
+        edited.addObject(QStringLiteral("new"), new CylinderObject(1.0f, 4.0f));
+        QVERIFY(edited.saveToFile(path));
+    }
+
+    Geo3DObjectSet::ReloadSummary summary;
+    QVERIFY(live.reloadFromFile(path, &summary));
+    QCOMPARE(summary.added, 1);
+    QCOMPARE(summary.removed, 1);
+    QCOMPARE(summary.modified, 2);
+    QCOMPARE(summary.unchanged, 1);
+    QVERIFY(!summary.layersChanged);
+    QVERIFY(!live.hasUnsavedChanges());
+
+    QCOMPARE(live.count(), 4);
+    QVERIFY(!live.contains(QStringLiteral("gone")));
+    QVERIFY(live.getObject(QStringLiteral("new"))->getEntity());
+    QCOMPARE(live.getObject(QStringLiteral("well"))->getObjectType(), QStringLiteral("Tube"));
+
+    // The face is updated in place, and its mesh follows the new outline
+    QCOMPARE(live.getObject(QStringLiteral("face")), face);
+    QCOMPARE(static_cast<FaceObject*>(face)->getVertexCount(), 8);
+    const QVector<Qt3DRender::QGeometryRenderer*> renderers =
+        face->getEntity()->componentsOfType<Qt3DRender::QGeometryRenderer>();
+    QCOMPARE(renderers.size(), 1);
+    QCOMPARE(Geo3DObject::geometryByteSize(renderers.first()),
+             8 * 3 * qint64(sizeof(float)) + 6 * 3 * qint64(sizeof(quint32)));
+
+    // Edits that only exist in memory make the reload refuse and leave the set alone
+    live.getObject(QStringLiteral("tube"))->setPosition(0.0f, 1.0f, 0.0f);
+    QVERIFY(live.hasUnsavedChanges());
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Not reloading")));
+    summary = Geo3DObjectSet::ReloadSummary();
+    QVERIFY(!live.reloadFromFile(path, &summary));
+    QCOMPARE(summary.modified, 0);
+    QCOMPARE(live.getObject(QStringLiteral("tube"))->getPosition(), QVector3D(0.0f, 1.0f, 0.0f));
+
+    live.releaseEntities();
+    delete root;
+}
+
+void tst_Model::renderModesRoundTrip()
+{
+    TubeObject tube(1.0f, 2.0f, 5.0f);
+    const QJsonObject automatic = tube.toJson();
+    QVERIFY(!automatic.contains(QStringLiteral("blendMode")));
+    QVERIFY(!automatic.contains(QStringLiteral("cullMode")));
+
+    tube.setBlendMode(Geo3DObject::TranslucentBlend);
+    tube.setCullMode(Geo3DObject::NoCull);
+    const QJsonObject overridden = tube.toJson();
+    QVERIFY(overridden != automatic);
+
+    Geo3DObject* copy = Geo3DObject::createFromJson(overridden);
+    QVERIFY(copy);
+    QCOMPARE(copy->getBlendMode(), Geo3DObject::TranslucentBlend);
+    QCOMPARE(copy->getCullMode(), Geo3DObject::NoCull);
+
+    // A record without overrides resets them when applied in place
+    QVERIFY(copy->fromJson(automatic));
+    QCOMPARE(copy->getBlendMode(), Geo3DObject::AutomaticBlend);
+    QCOMPARE(copy->getCullMode(), Geo3DObject::AutomaticCull);
+    delete copy;
+}
+
+void tst_Model::partialLoadSave()
+{
+    const QString path = m_dir.filePath(QStringLiteral("partial.g3dc"));
+    {
+        Geo3DObjectSet original;
+        for (int i = 0; i < 4; ++i) {
+            original.addObject(QStringLiteral("siteA/well_%1").arg(i), new CylinderObject(0.5f, 10.0f));
+            original.addObject(QStringLiteral("siteB/well_%1").arg(i), new CylinderObject(0.5f, 10.0f));
+        }
+        QVERIFY(original.saveToFile(path, Geo3DObjectSet::ContainerFormat));
+    }
+    const qint64 fileSize = QFileInfo(path).size();
+
+    Geo3DObjectSet partial;
+    QVERIFY(partial.loadPrefixFromFile(path, QStringLiteral("siteA/")));
+    QCOMPARE(partial.count(), 4);
+    QVERIFY(partial.isPartiallyLoaded());
+    QVERIFY(!partial.hasUnsavedChanges());
+
+    // Neither save may replace the complete file with the subset
+    partial.getObject(QStringLiteral("siteA/well_0"))->setPosition(1.0f, 0.0f, 0.0f);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Not overwriting")));
+    QVERIFY(!partial.saveIncremental(path, Geo3DObjectSet::ContainerFormat));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Not overwriting")));
+    QVERIFY(!partial.compactJournal(path, Geo3DObjectSet::ContainerFormat));
+    QVERIFY(partial.hasUnsavedChanges());
+
+    QCOMPARE(QFileInfo(path).size(), fileSize);
+    QVERIFY(!QFile::exists(Geo3DObjectSet::journalPath(path)));
+    Geo3DObjectSet complete;
+    QVERIFY(complete.loadFromFile(path));
+    QCOMPARE(complete.count(), 8);
+    QVERIFY(!complete.isPartiallyLoaded());
+
+    // Saving the subset elsewhere is fine
+    QVERIFY(partial.saveIncremental(m_dir.filePath(QStringLiteral("subset.json"))));
+}
+
+QTEST_GUILESS_MAIN(tst_Model)
+
+#include "tst_model.moc"
@@ -0,0 +1,230 @@
+/**
+ * @file tst_soak.cpp
+ * @brief Soak test for the lifetime of Qt3D entities across long sessions
+ *
+ * Repeats what a long viewer session does: opening and closing the scene,
+ * adding and removing objects, clearing the set and destroying a scene root
+ * before its set. After every cycle the Qt3D node count and the shared
+ * material and mesh registries must be back where they started, and the
+ * resident memory must stay flat once the allocator has warmed up.
+ * Everything runs without a window.
+ */
+
+#include <QtTest>
+#include <QFile>
+
+#include <Qt3DCore/QEntity>
+
+#include "geo3dobjectset.h"
+#include "geo3dprogressiveloader.h"
+#include "geo3dscenebuilder.h"
+#include "geo3dscenegenerator.h"
+#include "cylinderobject.h"
+
+// Resident memory may grow this much after the warm-up cycles, for allocator slack
+static const qint64 s_residentSlackBytes = 8 * 1024 * 1024;
+
+class tst_Soak : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void openCloseCycles_data();
+    void openCloseCycles();
+
+    void addRemoveCycles();
+    void clearCycles();
+    void sceneDestroyedFirst();
+
+private:
+    static int nodeCount(Qt3DCore::QEntity* root);
+    static qint64 residentBytes();
+    static void checkResidentGrowth(qint64 warmBytes);
+};
+
+int tst_Soak::nodeCount(Qt3DCore::QEntity* root)
+{
+    return int(root->findChildren<Qt3DCore::QNode*>().size()) + 1;
+}
+
+qint64 tst_Soak::residentBytes()
+{
+    // Linux only; elsewhere memory is not checked
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields[1].toLongLong() * 4096 : -1;
+}
+
+void tst_Soak::checkResidentGrowth(qint64 warmBytes)
+{
+    const qint64 finalBytes = residentBytes();
+    if (warmBytes < 0 || finalBytes < 0) {
+        return;
+    }
+
+    const qint64 growth = finalBytes - warmBytes;
+    qInfo() << "Resident memory after warm-up:" << warmBytes / 1024 << "KiB, growth since:" << growth / 1024 << "KiB";
+    QVERIFY2(growth < s_residentSlackBytes, qPrintable(QStringLiteral("Resident memory grew by %1 KiB").arg(growth / 1024)));
+}
+
+void tst_Soak::openCloseCycles_data()
+{
+    QTest::addColumn<bool>("progressive");
+    QTest::newRow("entities") << false;
+    QTest::newRow("proxies") << true;
+}
+
+void tst_Soak::openCloseCycles()
+{
+    QFETCH(bool, progressive);
+
+    // Same scene every cycle, as when the viewer window is shown and closed repeatedly
+    Geo3DObjectSet scene;
+    Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(2000, 20251123));
+
+    const int cycles = 50;
+    int expectedNodes = -1;
+    qint64 warmBytes = -1;
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        Qt3DCore::QEntity* root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr, !progressive);
+        if (progressive) {
+            Geo3DProgressiveLoader loader(&scene);
+            loader.start(root);
+            loader.finishNow();
+            QVERIFY(!loader.isRunning());
+            QCOMPARE(loader.upgradedCount(), loader.totalCount());
+        }
+
+        const int nodes = nodeCount(root);
+        if (expectedNodes < 0) {
+            expectedNodes = nodes;
+        }
+        QCOMPARE(nodes, expectedNodes);
+
+        // Shared nodes still referenced after every object let go have leaked
+        scene.releaseEntities();
+        QCOMPARE(scene.materialCount(), 0);
+        QCOMPARE(scene.geometryCount(), 0);
+        delete root;
+
+        if (cycle == 2) {
+            warmBytes = residentBytes();
+        }
+    }
+    checkResidentGrowth(warmBytes);
+}
+
+void tst_Soak::addRemoveCycles()
+{
+    Geo3DObjectSet scene;
+    Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(1000, 20251123));
+    Qt3DCore::QEntity* root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+
+    const int baseObjects = scene.count();
+    const int baseNodes = nodeCount(root);
+    const int baseMaterials = scene.materialCount();
+    const int baseGeometries = scene.geometryCount();
+
+    // Objects come and go while the scene stays up, as with reloads of an edited file
+    const int cycles = 100;
+    const int batch = 200;
+    qint64 warmBytes = -1;
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        for (int i = 0; i < batch; ++i) {
+            CylinderObject* cylinder = new CylinderObject(0.5f + 0.01f * i, 10.0f);
+            cylinder->setPosition(float(i), -5.0f, float(cycle));
+            cylinder->setDiffuseColor(QColor::fromHsv((i * 7) % 360, 200, 200));
+            scene.addObject(QStringLiteral("soak_%1").arg(i), cylinder);
+        }
+        scene.createEntities(root);
+        QVERIFY(nodeCount(root) > baseNodes);
+
+        for (int i = 0; i < batch; ++i) {
+            QVERIFY(scene.removeObject(QStringLiteral("soak_%1").arg(i)));
+        }
+        QCOMPARE(scene.count(), baseObjects);
+        QCOMPARE(nodeCount(root), baseNodes);
+        QCOMPARE(scene.materialCount(), baseMaterials);
+        QCOMPARE(scene.geometryCount(), baseGeometries);
+
+        if (cycle == 2) {
+            warmBytes = residentBytes();
+        }
+    }
+    checkResidentGrowth(warmBytes);
+
+    scene.releaseEntities();
+    delete root;
+}
+
+void tst_Soak::clearCycles()
+{
+    Geo3DObjectSet scene;
+    Qt3DCore::QEntity* root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+    const int emptyNodes = nodeCount(root);
+
+    // Loading a different file into the same set clears it first
+    const int cycles = 20;
+    qint64 warmBytes = -1;
+    for (int cycle = 0; cycle < cycles; ++cycle) {
+        Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(1000, 20251123 + cycle));
+        scene.createEntities(root);
+        QVERIFY(nodeCount(root) > emptyNodes);
+
+        // Each deleted object returns its references; the registries are not wiped
+        scene.clear();
+        QCOMPARE(nodeCount(root), emptyNodes);
+        QCOMPARE(scene.materialCount(), 0);
+        QCOMPARE(scene.geometryCount(), 0);
+
+        if (cycle == 2) {
+            warmBytes = residentBytes();
+        }
+    }
+    checkResidentGrowth(warmBytes);
+
+    delete root;
+}
+
+void tst_Soak::sceneDestroyedFirst()
+{
+    Geo3DObjectSet scene;
+    Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(500, 20251123));
+
+    // A window that goes away takes its entities with it; the set must cope
+    Qt3DCore::QEntity* root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+    const int nodes = nodeCount(root);
+    const int materials = scene.materialCount();
+    const int geometries = scene.geometryCount();
+    delete root;
+
+    // Destroyed shared nodes are replaced, not added next to the dead entries
+    root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+    QCOMPARE(nodeCount(root), nodes);
+    QCOMPARE(scene.materialCount(), materials);
+    QCOMPARE(scene.geometryCount(), geometries);
+    for (auto it = scene.constBegin(); it != scene.constEnd(); ++it) {
+        QVERIFY(it.value()->getEntity());
+        QCOMPARE(it.value()->getEntity()->parentNode(), static_cast<Qt3DCore::QNode*>(root));
+    }
+
+    // This time the scene is still up, so every reference must come back
+    scene.releaseEntities();
+    QCOMPARE(scene.materialCount(), 0);
+    QCOMPARE(scene.geometryCount(), 0);
+    delete root;
+
+    // A scene destroyed first leaves only dead entries, which are dropped
+    root = Geo3DSceneBuilder::createScene(&scene, nullptr, nullptr);
+    delete root;
+    scene.releaseEntities();
+    QCOMPARE(scene.materialCount(), 0);
+    QCOMPARE(scene.geometryCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(tst_Soak)
+
+#include "tst_soak.moc"
@@ -1,4 +1,5 @@
 #include "cylinderobject.h"
+#include "geo3dtrace.h"
 
 #include <Qt3DExtras/QCylinderMesh>
 #include <Qt3DCore/QEntity>
@@ -124,13 +125,44 @@ void CylinderObject::setTessellation(int rings, int slices)
 
 int CylinderObject::getTriangleCount() const
 {
-    // Approximation: cylinder has roughly 2 * slices * rings triangles
-    // This includes the sides and caps
-    return 2 * m_slices * m_rings + 2 * m_slices; // sides + caps
+    // Side bands between consecutive rings + one fan per cap
+    return 2 * m_slices * qMax(0, m_rings - 1) + 2 * m_slices;
+}
+
+Geo3DObject::MemoryUsage CylinderObject::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.parameterBytes = sizeof(CylinderObject);
+    return usage;
+}
+
+bool CylinderObject::isClosedSurface() const
+{
+    // QCylinderMesh generates both end caps
+    return true;
+}
+
+bool CylinderObject::getLocalBounds(QVector3D& minimum, QVector3D& maximum) const
+{
+    const float halfLength = m_length / 2.0f;
+    minimum = QVector3D(-m_radius, -halfLength, -m_radius);
+    maximum = QVector3D(m_radius, halfLength, m_radius);
+    return true;
+}
+
+QByteArray CylinderObject::getShapeKey() const
+{
+    QByteArray key = getObjectType().toLatin1();
+    key.append(reinterpret_cast<const char*>(&m_radius), sizeof(m_radius));
+    key.append(reinterpret_cast<const char*>(&m_length), sizeof(m_length));
+    key.append(reinterpret_cast<const char*>(&m_rings), sizeof(m_rings));
+    key.append(reinterpret_cast<const char*>(&m_slices), sizeof(m_slices));
+    return key;
 }
 
 Qt3DRender::QGeometryRenderer* CylinderObject::createGeometry()
 {
+    GEO3D_TRACE_SCOPE("tessellation", "CylinderObject::createGeometry");
     Qt3DExtras::QCylinderMesh* cylinderMesh = new Qt3DExtras::QCylinderMesh();
 
     // Set cylinder parameters
@@ -144,18 +176,8 @@ Qt3DRender::QGeometryRenderer* CylinderObject::createGeometry()
 
 void CylinderObject::recreateGeometryIfNeeded()
 {
-    // This is a simplified approach. In a more complete implementation,
-    // you would need access to the entity and geometry renderer to replace them.
-    // For now, this serves as a placeholder for the concept.
-    // The actual implementation would need to:
-    // 1. Check if createEntity() has been called (geometry exists)
-    // 2. Remove old geometry component from entity
-    // 3. Create new geometry with createGeometry()
-    // 4. Add new geometry component to entity
-
-    // Since we don't have direct access to these from the base class,
-    // a more complete implementation might require additional methods
-    // in the base class or a different architecture.
+    // Rebuilds the mesh once the entity exists; deferred inside edit transactions
+    invalidateGeometry();
 }
 
 QJsonObject CylinderObject::toJson() const
@@ -188,6 +210,7 @@ QJsonObject CylinderObject::toJson() const
 
     json["visible"] = isVisible();
     json["opacity"] = getOpacity();
+    renderModesToJson(json);
 
     // Cylinder properties
     QJsonObject cylinder;
@@ -251,6 +274,8 @@ bool CylinderObject::fromJson(const QJsonObject& json)
         setOpacity(json["opacity"].toDouble());
     }
 
+    renderModesFromJson(json);
+
     // Load cylinder properties
     if (json.contains("cylinder")) {
         QJsonObject cylinder = json["cylinder"].toObject();
@@ -270,6 +295,11 @@ QString CylinderObject::getObjectType() const
     return "Cylinder";
 }
 
+Geo3DObject* CylinderObject::clone() const
+{
+    return new CylinderObject(*this);
+}
+
 // Static registration - runs when the program starts
 static bool s_cylinderRegistered = []() {
     Geo3DObject::registerObjectType("Cylinder", []() -> Geo3DObject* {
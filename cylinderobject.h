@@ -178,20 +178,59 @@ public:
     void setTessellation(int rings, int slices);
 
     /**
-     * @brief Gets the approximate number of triangles in the mesh
+     * @brief Gets the number of triangles in the mesh
      *
-     * This can be useful for performance estimation.
+     * Matches the tessellation of Qt3DExtras::QCylinderMesh: rings - 1 bands
+     * of 2 * slices triangles along the side, and a fan of slices triangles
+     * per cap.
      *
-     * @return Approximate triangle count based on current tessellation settings
+     * @return Exact triangle count for the current tessellation settings
      */
-    int getTriangleCount() const;
+    int getTriangleCount() const override;
+
+    /**
+     * @brief Gets the memory held by the cylinder
+     *
+     * All shape parameters are stored inline, so this is the object size.
+     */
+    MemoryUsage getMemoryUsage() const override;
+
+    /**
+     * @brief Indicates that the capped cylinder encloses a volume
+     *
+     * Allows back-face culling when the cylinder is opaque.
+     *
+     * @return Always true
+     */
+    bool isClosedSurface() const override;
+
+    /**
+     * @brief Gets the object-space bounds of the cylinder
+     *
+     * The cylinder is centered at the origin with its axis along Y.
+     *
+     * @param minimum Receives (-radius, -length/2, -radius)
+     * @param maximum Receives (radius, length/2, radius)
+     * @return Always true
+     */
+    bool getLocalBounds(QVector3D& minimum, QVector3D& maximum) const override;
+
+    /**
+     * @brief Identifies the mesh by radius, length and tessellation
+     *
+     * Cylinders with equal parameters share one mesh within a set.
+     */
+    QByteArray getShapeKey() const override;
 
     // JSON Serialization
     QJsonObject toJson() const override;
     bool fromJson(const QJsonObject& json) override;
     QString getObjectType() const override;
+    Geo3DObject* clone() const override;
 
 protected:
+    CylinderObject(const CylinderObject& other) = default;
+
     /**
      * @brief Creates the cylinder geometry
      *
@@ -1,12 +1,16 @@
 #include "faceobject.h"
+#include "geo3dtrace.h"
 
 #include <Qt3DRender/QGeometryRenderer>
-#include <Qt3DCore/QGeometry>
-#include <Qt3DCore/QBuffer>
-#include <Qt3DCore/QAttribute>
 #include <Qt3DCore/QEntity>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QtEndian>
+
+// RFC 8746 typed array tag: IEEE 754 binary32, little endian
+static const QCborTag s_float32LETypedArrayTag = QCborTag(85);
 
 // Static registration
 static bool s_faceRegistered = []() {
@@ -94,13 +98,51 @@ QVector<QVector3D> FaceObject::get3DVertices() const
     return vertices3D;
 }
 
+bool FaceObject::getLocalBounds(QVector3D& minimum, QVector3D& maximum) const
+{
+    if (m_vertices.isEmpty()) {
+        return false;
+    }
+
+    float minX = m_vertices.first().x();
+    float maxX = minX;
+    float minZ = m_vertices.first().y();
+    float maxZ = minZ;
+    for (const QVector2D& vertex : m_vertices) {
+        minX = qMin(minX, vertex.x());
+        maxX = qMax(maxX, vertex.x());
+        minZ = qMin(minZ, vertex.y());
+        maxZ = qMax(maxZ, vertex.y());
+    }
+
+    minimum = QVector3D(minX, m_elevation, minZ);
+    maximum = QVector3D(maxX, m_elevation, maxZ);
+    return true;
+}
+
+QByteArray FaceObject::getShapeKey() const
+{
+    QByteArray key = getObjectType().toLatin1();
+    key.append(reinterpret_cast<const char*>(&m_elevation), sizeof(m_elevation));
+    key.append(reinterpret_cast<const char*>(m_vertices.constData()), m_vertices.size() * sizeof(QVector2D));
+    return key;
+}
+
 Qt3DRender::QGeometryRenderer* FaceObject::createGeometry()
 {
-    if (m_vertices.size() < 3) {
+    GEO3D_TRACE_SCOPE("tessellation", "FaceObject::createGeometry");
+    MeshData mesh;
+    if (!generateMesh(mesh)) {
         return nullptr;
     }
+    return createGeometryFromMesh(mesh);
+}
 
-    Qt3DCore::QGeometry* geometry = new Qt3DCore::QGeometry();    // Changed from Qt3DRender::QGeometry
+bool FaceObject::generateMesh(MeshData& mesh) const
+{
+    if (m_vertices.size() < 3) {
+        return false;
+    }
 
     // Get 3D vertices
     QVector<QVector3D> vertices3D = get3DVertices();
@@ -119,9 +161,6 @@ Qt3DRender::QGeometryRenderer* FaceObject::createGeometry()
         *vertexPtr++ = vertices3D[i].z();
     }
 
-    Qt3DCore::QBuffer* vertexBuffer = new Qt3DCore::QBuffer(geometry);    // Changed from Qt3DRender::QBuffer
-    vertexBuffer->setData(vertexBufferData);
-
     // Create index buffer
     QByteArray indexBufferData;
     indexBufferData.resize(indices.size() * sizeof(unsigned int));
@@ -130,53 +169,135 @@ Qt3DRender::QGeometryRenderer* FaceObject::createGeometry()
         *indexPtr++ = index;
     }
 
-    Qt3DCore::QBuffer* indexBuffer = new Qt3DCore::QBuffer(geometry);    // Changed from Qt3DRender::QBuffer
-    indexBuffer->setData(indexBufferData);
-
-    // Position attribute
-    Qt3DCore::QAttribute* positionAttribute = new Qt3DCore::QAttribute(geometry);    // Changed from Qt3DRender::QAttribute
-    positionAttribute->setName(Qt3DCore::QAttribute::defaultPositionAttributeName());    // Changed namespace
-    positionAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);    // Changed namespace
-    positionAttribute->setVertexSize(3);
-    positionAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);    // Changed namespace
-    positionAttribute->setBuffer(vertexBuffer);
-    positionAttribute->setByteStride(3 * sizeof(float));
-    positionAttribute->setCount(vertices3D.size());
-    geometry->addAttribute(positionAttribute);
-
-    // Index attribute
-    Qt3DCore::QAttribute* indexAttribute = new Qt3DCore::QAttribute(geometry);    // Changed from Qt3DRender::QAttribute
-    indexAttribute->setAttributeType(Qt3DCore::QAttribute::IndexAttribute);    // Changed namespace
-    indexAttribute->setVertexBaseType(Qt3DCore::QAttribute::UnsignedInt);    // Changed namespace
-    indexAttribute->setBuffer(indexBuffer);
-    indexAttribute->setCount(indices.size());
-    geometry->addAttribute(indexAttribute);
-
-    Qt3DRender::QGeometryRenderer* renderer = new Qt3DRender::QGeometryRenderer();
-    renderer->setGeometry(geometry);
-    renderer->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
-
-    return renderer;
+    mesh.vertices = vertexBufferData;
+    mesh.indices = indexBufferData;
+    mesh.vertexCount = vertices3D.size();
+    mesh.indexCount = indices.size();
+    mesh.hasNormals = false;
+    return true;
+}
+
+bool FaceObject::hasGeneratedMesh() const
+{
+    return true;
+}
+
+// Twice the signed area of triangle abc; positive when counter-clockwise
+static double signedArea(const QVector2D& a, const QVector2D& b, const QVector2D& c)
+{
+    return (double(b.x()) - a.x()) * (double(c.y()) - a.y()) - (double(b.y()) - a.y()) * (double(c.x()) - a.x());
+}
+
+// Inclusive test, so vertices on an edge of a candidate ear also block it
+static bool pointInTriangle(const QVector2D& p, const QVector2D& a, const QVector2D& b, const QVector2D& c,
+                            double orientation)
+{
+    return orientation * signedArea(a, b, p) >= 0.0
+        && orientation * signedArea(b, c, p) >= 0.0
+        && orientation * signedArea(c, a, p) >= 0.0;
+}
+
+int FaceObject::getTriangleCount() const
+{
+    // Every clipped ear removes one vertex until a single triangle is left
+    return qMax(0, int(m_vertices.size()) - 2);
+}
+
+Geo3DObject::MemoryUsage FaceObject::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.parameterBytes = sizeof(FaceObject);
+    usage.vertexArrayBytes = m_vertices.capacity() * qint64(sizeof(QVector2D));
+    return usage;
 }
 
 QVector<unsigned int> FaceObject::triangulate() const
 {
     QVector<unsigned int> indices;
+    const int count = m_vertices.size();
+    if (count < 3) {
+        return indices;
+    }
+    indices.reserve((count - 2) * 3);
+
+    // Ear clipping, so concave outlines are filled correctly. Ears must turn
+    // the same way as the outline, whichever winding it was given in.
+    double area = 0.0;
+    for (int i = 0; i < count; ++i) {
+        const QVector2D& a = m_vertices[i];
+        const QVector2D& b = m_vertices[(i + 1) % count];
+        area += double(a.x()) * b.y() - double(b.x()) * a.y();
+    }
+    const double orientation = area < 0.0 ? -1.0 : 1.0;
+
+    QVector<int> remaining(count);
+    for (int i = 0; i < count; ++i) {
+        remaining[i] = i;
+    }
 
-    // Simple fan triangulation (works for convex polygons)
-    // For complex polygons, you'd need a proper triangulation algorithm
-    if (m_vertices.size() >= 3) {
-        for (int i = 1; i < m_vertices.size() - 1; ++i) {
-            indices.append(0);
-            indices.append(i);
-            indices.append(i + 1);
+    int current = 0;
+    int attempts = 0;
+    while (remaining.size() > 3) {
+        const int size = remaining.size();
+        current %= size;
+        const int previous = remaining[(current + size - 1) % size];
+        const int vertex = remaining[current];
+        const int next = remaining[(current + 1) % size];
+
+        const QVector2D& a = m_vertices[previous];
+        const QVector2D& b = m_vertices[vertex];
+        const QVector2D& c = m_vertices[next];
+
+        bool isEar = orientation * signedArea(a, b, c) > 0.0;
+        for (int k = 0; isEar && k < size; ++k) {
+            const int other = remaining[k];
+            if (other == previous || other == vertex || other == next) {
+                continue;
+            }
+            const QVector2D& p = m_vertices[other];
+            if (p != a && p != b && p != c && pointInTriangle(p, a, b, c, orientation)) {
+                isEar = false;
+            }
+        }
+
+        // A self-intersecting or degenerate outline may have no ear left; clip anyway rather than loop forever
+        if (isEar || attempts >= size) {
+            indices.append(previous);
+            indices.append(vertex);
+            indices.append(next);
+            remaining.remove(current);
+            attempts = 0;
+        } else {
+            ++current;
+            ++attempts;
         }
     }
 
+    indices.append(remaining[0]);
+    indices.append(remaining[1]);
+    indices.append(remaining[2]);
     return indices;
 }
 
 QJsonObject FaceObject::toJson() const
+{
+    QJsonObject json = toJsonWithoutVertices();
+
+    QJsonArray verticesArray;
+    for (const QVector2D& vertex : m_vertices) {
+        QJsonObject vertexObj;
+        vertexObj["x"] = vertex.x();
+        vertexObj["z"] = vertex.y();
+        verticesArray.append(vertexObj);
+    }
+    QJsonObject face = json["face"].toObject();
+    face["vertices"] = verticesArray;
+    json["face"] = face;
+
+    return json;
+}
+
+QJsonObject FaceObject::toJsonWithoutVertices() const
 {
     QJsonObject json;
     json["type"] = getObjectType();
@@ -206,19 +327,11 @@ QJsonObject FaceObject::toJson() const
 
     json["visible"] = isVisible();
     json["opacity"] = getOpacity();
+    renderModesToJson(json);
 
     // Face-specific properties
     QJsonObject face;
     face["elevation"] = m_elevation;
-
-    QJsonArray verticesArray;
-    for (const QVector2D& vertex : m_vertices) {
-        QJsonObject vertexObj;
-        vertexObj["x"] = vertex.x();
-        vertexObj["z"] = vertex.y();
-        verticesArray.append(vertexObj);
-    }
-    face["vertices"] = verticesArray;
     json["face"] = face;
 
     return json;
@@ -274,38 +387,102 @@ bool FaceObject::fromJson(const QJsonObject& json)
         setOpacity(json["opacity"].toDouble());
     }
 
+    renderModesFromJson(json);
+
     // Load face-specific properties
     if (json.contains("face")) {
         QJsonObject face = json["face"].toObject();
 
+        // Through the setters, so an object updated in place gets a new mesh
         if (face.contains("elevation")) {
-            m_elevation = face["elevation"].toDouble();
+            setElevation(face["elevation"].toDouble());
         }
 
         if (face.contains("vertices") && face["vertices"].isArray()) {
             QJsonArray verticesArray = face["vertices"].toArray();
-            m_vertices.clear();
+            QVector<QVector2D> vertices;
+            vertices.reserve(verticesArray.size());
 
             for (const QJsonValue& vertexValue : verticesArray) {
                 if (vertexValue.isObject()) {
                     QJsonObject vertexObj = vertexValue.toObject();
                     float x = vertexObj["x"].toDouble();
                     float z = vertexObj["z"].toDouble();
-                    m_vertices.append(QVector2D(x, z));
+                    vertices.append(QVector2D(x, z));
                 }
             }
+            setVertices(vertices);
         }
     }
 
     return true;
 }
 
+QCborMap FaceObject::toCbor() const
+{
+    // The vertices never go through JSON; they are x,z pairs packed as float32
+    QCborMap cbor = QCborMap::fromJsonObject(toJsonWithoutVertices());
+
+    QByteArray packed;
+    packed.resize(m_vertices.size() * 2 * sizeof(float));
+    uchar* out = reinterpret_cast<uchar*>(packed.data());
+    for (const QVector2D& vertex : m_vertices) {
+        qToLittleEndian<float>(vertex.x(), out);
+        qToLittleEndian<float>(vertex.y(), out + sizeof(float));
+        out += 2 * sizeof(float);
+    }
+
+    QCborMap face = cbor.value(QStringLiteral("face")).toMap();
+    face.insert(QStringLiteral("vertices"), QCborValue(s_float32LETypedArrayTag, packed));
+    cbor.insert(QStringLiteral("face"), face);
+    return cbor;
+}
+
+bool FaceObject::fromCbor(const QCborMap& cbor)
+{
+    QCborMap face = cbor.value(QStringLiteral("face")).toMap();
+    QCborValue vertices = face.value(QStringLiteral("vertices"));
+
+    if (!vertices.isTag() || vertices.tag() != s_float32LETypedArrayTag) {
+        return Geo3DObject::fromCbor(cbor);
+    }
+
+    // Everything except the packed array goes through the JSON path
+    QCborMap rest = cbor;
+    face.remove(QStringLiteral("vertices"));
+    rest.insert(QStringLiteral("face"), face);
+    if (!fromJson(rest.toJsonObject())) {
+        return false;
+    }
+
+    QByteArray packed = vertices.taggedValue().toByteArray();
+    const int count = packed.size() / int(2 * sizeof(float));
+    const uchar* in = reinterpret_cast<const uchar*>(packed.constData());
+
+    m_vertices.clear();
+    m_vertices.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        float x = qFromLittleEndian<float>(in);
+        float z = qFromLittleEndian<float>(in + sizeof(float));
+        m_vertices.append(QVector2D(x, z));
+        in += 2 * sizeof(float);
+    }
+    recreateGeometryIfNeeded();
+
+    return true;
+}
+
 QString FaceObject::getObjectType() const
 {
     return "Face";
 }
 
+Geo3DObject* FaceObject::clone() const
+{
+    return new FaceObject(*this);
+}
+
 void FaceObject::recreateGeometryIfNeeded()
 {
-    // Placeholder - same concept as CylinderObject
+    invalidateGeometry();
 }
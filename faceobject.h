@@ -102,23 +102,69 @@ public:
      */
     QVector<QVector3D> get3DVertices() const;
 
+    /**
+     * @brief Gets the object-space bounds of the face
+     *
+     * The box is flat in Y at the elevation of the face.
+     *
+     * @return false if the face has no vertices
+     */
+    bool getLocalBounds(QVector3D& minimum, QVector3D& maximum) const override;
+
+    /**
+     * @brief Identifies the mesh by elevation and the exact vertex list
+     */
+    QByteArray getShapeKey() const override;
+
+    /**
+     * @brief Positions of the outline vertices and the triangulation indices
+     */
+    bool generateMesh(MeshData& mesh) const override;
+    bool hasGeneratedMesh() const override;
+
+    /**
+     * @brief Gets the number of triangles produced by triangulate()
+     *
+     * @return Vertex count - 2, or 0 for fewer than three vertices
+     */
+    int getTriangleCount() const override;
+
+    /**
+     * @brief Gets the memory held by the face, including the capacity of its vertex array
+     */
+    MemoryUsage getMemoryUsage() const override;
+
+    /**
+     * @brief Triangulates the face vertices by ear clipping
+     *
+     * Works for any simple polygon, convex or concave, in either winding.
+     * Triangles keep the winding of the outline.
+     *
+     * @return Indices into the vertex list, three per triangle
+     */
+    QVector<unsigned int> triangulate() const;
+
     // JSON Serialization
     QJsonObject toJson() const override;
     bool fromJson(const QJsonObject& json) override;
     QString getObjectType() const override;
+    Geo3DObject* clone() const override;
+
+    // CBOR Serialization - vertices are stored as a packed float32 typed array
+    QCborMap toCbor() const override;
+    bool fromCbor(const QCborMap& cbor) override;
 
 protected:
+    FaceObject(const FaceObject& other) = default;
+
     Qt3DRender::QGeometryRenderer* createGeometry() override;
 
 private:
     float m_elevation;
     QVector<QVector2D> m_vertices;
 
-    /**
-     * @brief Triangulates the face vertices
-     * @return Indices for triangulation
-     */
-    QVector<unsigned int> triangulate() const;
+    // Every member of toJson() except the vertex array, for the packed CBOR form
+    QJsonObject toJsonWithoutVertices() const;
 
     void recreateGeometryIfNeeded();
 };
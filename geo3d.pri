@@ -0,0 +1,53 @@
+# Scene model and serialization, shared by the viewer and the benchmarks
+
+QT += core concurrent 3dcore 3drender 3dextras 3dlogic
+
+CONFIG += c++17
+
+# Scoped trace instrumentation (see geo3dtrace.h); qmake CONFIG+=geo3d_trace
+geo3d_trace {
+    DEFINES += GEO3D_TRACE
+}
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/cylinderobject.cpp \
+    $$PWD/faceobject.cpp \
+    $$PWD/geo3dcamerapath.cpp \
+    $$PWD/geo3dcompressedstream.cpp \
+    $$PWD/geo3dentitypool.cpp \
+    $$PWD/geo3dgeometryregistry.cpp \
+    $$PWD/geo3djsonstreamreader.cpp \
+    $$PWD/geo3dmaterialregistry.cpp \
+    $$PWD/geo3dobject.cpp \
+    $$PWD/geo3dobjectset.cpp \
+    $$PWD/geo3dperformancemonitor.cpp \
+    $$PWD/geo3dprogressiveloader.cpp \
+    $$PWD/geo3dscenebuilder.cpp \
+    $$PWD/geo3dscenecontainer.cpp \
+    $$PWD/geo3dscenegenerator.cpp \
+    $$PWD/geo3dtessellationcache.cpp \
+    $$PWD/geo3dtrace.cpp \
+    $$PWD/tubeobject.cpp
+
+HEADERS += \
+    $$PWD/cylinderobject.h \
+    $$PWD/faceobject.h \
+    $$PWD/geo3dcamerapath.h \
+    $$PWD/geo3dcompressedstream.h \
+    $$PWD/geo3dentitypool.h \
+    $$PWD/geo3dgeometryregistry.h \
+    $$PWD/geo3djsonstreamreader.h \
+    $$PWD/geo3dmaterialregistry.h \
+    $$PWD/geo3dobject.h \
+    $$PWD/geo3dobjectset.h \
+    $$PWD/geo3dperformancemonitor.h \
+    $$PWD/geo3dprogressiveloader.h \
+    $$PWD/geo3dscenebuilder.h \
+    $$PWD/geo3dscenecontainer.h \
+    $$PWD/geo3dscenegenerator.h \
+    $$PWD/geo3dtessellationcache.h \
+    $$PWD/geo3dtrace.h \
+    $$PWD/tubeobject.h
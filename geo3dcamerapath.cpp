@@ -0,0 +1,279 @@
+#include "geo3dcamerapath.h"
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DLogic/QFrameAction>
+#include <Qt3DRender/QCamera>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QFile>
+#include <QSaveFile>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+
+static QJsonArray vectorToJson(const QVector3D& vector)
+{
+    return QJsonArray{vector.x(), vector.y(), vector.z()};
+}
+
+static QVector3D vectorFromJson(const QJsonValue& value)
+{
+    const QJsonArray array = value.toArray();
+    return QVector3D(array.at(0).toDouble(), array.at(1).toDouble(), array.at(2).toDouble());
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const QVector<double>& sorted, double fraction)
+{
+    if (sorted.isEmpty()) {
+        return 0.0;
+    }
+    const int rank = qBound(0, int(qCeil(fraction * sorted.size())) - 1, int(sorted.size()) - 1);
+    return sorted[rank];
+}
+
+void Geo3DCameraPath::append(const Keyframe& keyframe)
+{
+    m_keyframes.append(keyframe);
+}
+
+void Geo3DCameraPath::clear()
+{
+    m_keyframes.clear();
+}
+
+bool Geo3DCameraPath::isEmpty() const
+{
+    return m_keyframes.isEmpty();
+}
+
+int Geo3DCameraPath::count() const
+{
+    return m_keyframes.size();
+}
+
+const Geo3DCameraPath::Keyframe& Geo3DCameraPath::keyframe(int index) const
+{
+    return m_keyframes.at(index);
+}
+
+qint64 Geo3DCameraPath::durationMs() const
+{
+    return m_keyframes.isEmpty() ? 0 : m_keyframes.last().timeMs;
+}
+
+Geo3DCameraPath::Keyframe Geo3DCameraPath::capture(const Qt3DRender::QCamera* camera, qint64 timeMs)
+{
+    Keyframe keyframe;
+    keyframe.timeMs = timeMs;
+    keyframe.position = camera->position();
+    keyframe.viewCenter = camera->viewCenter();
+    keyframe.upVector = camera->upVector();
+    keyframe.fieldOfView = camera->fieldOfView();
+    return keyframe;
+}
+
+void Geo3DCameraPath::apply(Qt3DRender::QCamera* camera, const Keyframe& keyframe)
+{
+    camera->setPosition(keyframe.position);
+    camera->setViewCenter(keyframe.viewCenter);
+    camera->setUpVector(keyframe.upVector);
+    camera->setFieldOfView(keyframe.fieldOfView);
+}
+
+bool Geo3DCameraPath::saveToFile(const QString& filePath) const
+{
+    QJsonArray keyframes;
+    for (const Keyframe& keyframe : m_keyframes) {
+        QJsonObject json;
+        json["time"] = keyframe.timeMs;
+        json["position"] = vectorToJson(keyframe.position);
+        json["viewCenter"] = vectorToJson(keyframe.viewCenter);
+        json["upVector"] = vectorToJson(keyframe.upVector);
+        json["fieldOfView"] = keyframe.fieldOfView;
+        keyframes.append(json);
+    }
+
+    QJsonObject root;
+    root["version"] = "1.0";
+    root["keyframes"] = keyframes;
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open file for writing:" << filePath;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Error writing to file:" << filePath;
+        return false;
+    }
+    return true;
+}
+
+bool Geo3DCameraPath::loadFromFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open file for reading:" << filePath;
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "Invalid camera path file:" << filePath << error.errorString();
+        return false;
+    }
+
+    QVector<Keyframe> keyframes;
+    const QJsonArray array = document.object()["keyframes"].toArray();
+    keyframes.reserve(array.size());
+    for (const QJsonValue& value : array) {
+        const QJsonObject json = value.toObject();
+        Keyframe keyframe;
+        keyframe.timeMs = qint64(json["time"].toDouble());
+        keyframe.position = vectorFromJson(json["position"]);
+        keyframe.viewCenter = vectorFromJson(json["viewCenter"]);
+        keyframe.upVector = vectorFromJson(json["upVector"]);
+        keyframe.fieldOfView = float(json["fieldOfView"].toDouble(45.0));
+        keyframes.append(keyframe);
+    }
+
+    m_keyframes = keyframes;
+    return true;
+}
+
+Geo3DCameraRecorder::Geo3DCameraRecorder(Qt3DCore::QEntity* rootEntity, Qt3DRender::QCamera* camera,
+                                         QObject* parent)
+    : QObject(parent)
+    , m_frameEntity(new Qt3DCore::QEntity(rootEntity))
+    , m_camera(camera)
+    , m_mode(Idle)
+    , m_nextKeyframe(0)
+    , m_lastFrameNs(0)
+{
+    Qt3DLogic::QFrameAction* frameAction = new Qt3DLogic::QFrameAction(m_frameEntity);
+    m_frameEntity->addComponent(frameAction);
+    connect(frameAction, &Qt3DLogic::QFrameAction::triggered, this, &Geo3DCameraRecorder::onFrame);
+}
+
+Geo3DCameraRecorder::~Geo3DCameraRecorder()
+{
+    delete m_frameEntity;
+}
+
+void Geo3DCameraRecorder::startRecording()
+{
+    m_path.clear();
+    m_mode = Recording;
+    m_clock.start();
+}
+
+Geo3DCameraPath Geo3DCameraRecorder::stopRecording()
+{
+    if (m_mode == Recording) {
+        m_mode = Idle;
+    }
+    return m_path;
+}
+
+void Geo3DCameraRecorder::startReplay(const Geo3DCameraPath& path)
+{
+    m_path = path;
+    m_nextKeyframe = 0;
+    m_frameTimes.clear();
+    m_frameTimes.reserve(path.count());
+    m_lastFrameNs = -1;
+    m_mode = Replaying;
+    m_clock.start();
+}
+
+void Geo3DCameraRecorder::stop()
+{
+    m_mode = Idle;
+}
+
+bool Geo3DCameraRecorder::isRecording() const
+{
+    return m_mode == Recording;
+}
+
+bool Geo3DCameraRecorder::isReplaying() const
+{
+    return m_mode == Replaying;
+}
+
+QVector<double> Geo3DCameraRecorder::frameTimes() const
+{
+    return m_frameTimes;
+}
+
+void Geo3DCameraRecorder::onFrame(float dt)
+{
+    Q_UNUSED(dt);
+    if (m_mode == Idle || !m_camera) {
+        return;
+    }
+
+    if (m_mode == Recording) {
+        m_path.append(Geo3DCameraPath::capture(m_camera, m_clock.elapsed()));
+        return;
+    }
+
+    const qint64 now = m_clock.nsecsElapsed();
+    if (m_lastFrameNs >= 0) {
+        m_frameTimes.append((now - m_lastFrameNs) / 1.0e6);
+    }
+    m_lastFrameNs = now;
+
+    // One keyframe per frame; the tick after the last one means it has been rendered
+    if (m_nextKeyframe < m_path.count()) {
+        Geo3DCameraPath::apply(m_camera, m_path.keyframe(m_nextKeyframe++));
+        return;
+    }
+
+    m_mode = Idle;
+    emit replayFinished();
+}
+
+QJsonObject Geo3DCameraRecorder::summarizeFrameTimes(const QVector<double>& frameTimes)
+{
+    QVector<double> sorted = frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (double frameTime : std::as_const(sorted)) {
+        total += frameTime;
+    }
+
+    QJsonObject summary;
+    summary["frames"] = int(sorted.size());
+    summary["frameTimeMeanMs"] = sorted.isEmpty() ? 0.0 : total / sorted.size();
+    summary["frameTimeP95Ms"] = percentile(sorted, 0.95);
+    summary["frameTimeP99Ms"] = percentile(sorted, 0.99);
+    return summary;
+}
+
+bool Geo3DCameraRecorder::saveFrameTimes(const QString& filePath, const QVector<double>& frameTimes)
+{
+    QJsonArray frames;
+    for (double frameTime : frameTimes) {
+        frames.append(frameTime);
+    }
+
+    QJsonObject root = summarizeFrameTimes(frameTimes);
+    root["frameTimesMs"] = frames;
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open file for writing:" << filePath;
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Error writing to file:" << filePath;
+        return false;
+    }
+    return true;
+}
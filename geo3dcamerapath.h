@@ -0,0 +1,229 @@
+/**
+ * @file geo3dcamerapath.h
+ * @brief Header file for the Geo3DCameraPath and Geo3DCameraRecorder classes
+ */
+
+#ifndef GEO3DCAMERAPATH_H
+#define GEO3DCAMERAPATH_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QVector3D>
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+QT_BEGIN_NAMESPACE
+namespace Qt3DCore {
+class QEntity;
+}
+namespace Qt3DRender {
+class QCamera;
+}
+namespace Qt3DLogic {
+class QFrameAction;
+}
+QT_END_NAMESPACE
+
+/**
+ * @class Geo3DCameraPath
+ * @brief A recorded sequence of camera poses, one per rendered frame
+ *
+ * Paths are stored as JSON. Coordinates are written with enough digits to
+ * restore the recorded float values exactly, so a replayed path renders the
+ * same views as the original session.
+ *
+ * File layout:
+ * @code
+ * {"version": "1.0",
+ *  "keyframes": [{"time": 0, "position": [x, y, z], "viewCenter": [x, y, z],
+ *                 "upVector": [x, y, z], "fieldOfView": 45}, ...]}
+ * @endcode
+ */
+class Geo3DCameraPath
+{
+public:
+    /**
+     * @brief Camera pose at one frame
+     */
+    struct Keyframe
+    {
+        qint64 timeMs = 0;  ///< Time since the start of the recording
+        QVector3D position;
+        QVector3D viewCenter;
+        QVector3D upVector;
+        float fieldOfView = 45.0f;
+    };
+
+    void append(const Keyframe& keyframe);
+    void clear();
+
+    bool isEmpty() const;
+    int count() const;
+    const Keyframe& keyframe(int index) const;
+
+    /**
+     * @brief Gets the length of the recording
+     *
+     * @return Time of the last keyframe in milliseconds, 0 if empty
+     */
+    qint64 durationMs() const;
+
+    /**
+     * @brief Reads the current pose of a camera
+     *
+     * @param camera Camera to read
+     * @param timeMs Time stamp for the keyframe
+     * @return Keyframe with the camera's pose
+     */
+    static Keyframe capture(const Qt3DRender::QCamera* camera, qint64 timeMs);
+
+    /**
+     * @brief Moves a camera to a recorded pose
+     *
+     * @param camera Camera to move
+     * @param keyframe Pose to apply
+     */
+    static void apply(Qt3DRender::QCamera* camera, const Keyframe& keyframe);
+
+    /**
+     * @brief Saves the path to a JSON file
+     *
+     * @param filePath Path to the output file
+     * @return true if the file was written
+     */
+    bool saveToFile(const QString& filePath) const;
+
+    /**
+     * @brief Loads a path saved with saveToFile(), replacing the current keyframes
+     *
+     * @param filePath Path to the input file
+     * @return true if the file was read; the path is unchanged on error
+     */
+    bool loadFromFile(const QString& filePath);
+
+private:
+    QVector<Keyframe> m_keyframes;
+};
+
+/**
+ * @class Geo3DCameraRecorder
+ * @brief Records camera paths from a live scene and replays them with per-frame timings
+ *
+ * The recorder ticks once per frame through a Qt3DLogic::QFrameAction on
+ * an entity it adds below the scene root. While recording, it captures the
+ * camera pose on every frame. While replaying, it applies the next keyframe
+ * on every frame, regardless of how long frames take, so two builds render
+ * exactly the same sequence of views; the time of each frame is kept for
+ * comparison.
+ *
+ * Example usage:
+ * @code
+ * Geo3DCameraRecorder* recorder = new Geo3DCameraRecorder(rootEntity, window->camera(), this);
+ * recorder->startReplay(path);
+ * connect(recorder, &Geo3DCameraRecorder::replayFinished, [recorder]() {
+ *     qDebug() << Geo3DCameraRecorder::summarizeFrameTimes(recorder->frameTimes());
+ * });
+ * @endcode
+ */
+class Geo3DCameraRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Creates an idle recorder for a scene
+     *
+     * @param rootEntity Scene root; the recorder's frame entity is added below it
+     * @param camera Camera to record or drive
+     * @param parent QObject parent
+     */
+    explicit Geo3DCameraRecorder(Qt3DCore::QEntity* rootEntity, Qt3DRender::QCamera* camera,
+                                 QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Removes the frame entity from the scene if the scene still exists.
+     */
+    ~Geo3DCameraRecorder();
+
+    void startRecording();
+
+    /**
+     * @brief Stops recording
+     *
+     * @return The poses captured since startRecording()
+     */
+    Geo3DCameraPath stopRecording();
+
+    /**
+     * @brief Replays a path, one keyframe per frame
+     *
+     * Emits replayFinished() after the last keyframe has been rendered.
+     *
+     * @param path Path to replay
+     */
+    void startReplay(const Geo3DCameraPath& path);
+
+    /**
+     * @brief Stops recording or replaying without emitting replayFinished()
+     */
+    void stop();
+
+    bool isRecording() const;
+    bool isReplaying() const;
+
+    /**
+     * @brief Gets the frame times of the current or last replay
+     *
+     * @return Milliseconds between consecutive frames, in replay order
+     */
+    QVector<double> frameTimes() const;
+
+    /**
+     * @brief Summarizes frame times for machine-readable reports
+     *
+     * @param frameTimes Frame times in milliseconds
+     * @return Object with "frames", "frameTimeMeanMs", "frameTimeP95Ms" and "frameTimeP99Ms"
+     */
+    static QJsonObject summarizeFrameTimes(const QVector<double>& frameTimes);
+
+    /**
+     * @brief Writes frame times and their summary to a JSON file
+     *
+     * @param filePath Path to the output file
+     * @param frameTimes Frame times in milliseconds
+     * @return true if the file was written
+     */
+    static bool saveFrameTimes(const QString& filePath, const QVector<double>& frameTimes);
+
+signals:
+    /**
+     * @brief Emitted when a replay has applied and rendered its last keyframe
+     */
+    void replayFinished();
+
+private slots:
+    void onFrame(float dt);
+
+private:
+    enum Mode {
+        Idle,
+        Recording,
+        Replaying
+    };
+
+    QPointer<Qt3DCore::QEntity> m_frameEntity;
+    QPointer<Qt3DRender::QCamera> m_camera;
+    Mode m_mode;
+
+    Geo3DCameraPath m_path;
+    int m_nextKeyframe;
+
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameNs;
+    QVector<double> m_frameTimes;
+};
+
+#endif // GEO3DCAMERAPATH_H
@@ -0,0 +1,229 @@
+#include "geo3dcompressedstream.h"
+
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+static const char s_magic[4] = {'G', '3', 'D', 'Z'};
+static const quint32 s_version = 1;
+static const int s_headerSize = 4 + 4 + 4 + 8 + 4;
+
+// Upper bound for a chunk read from a file, to reject corrupt sizes early
+static const quint32 s_maxChunkSize = 256 * 1024 * 1024;
+
+bool Geo3DCompressedStream::write(QIODevice* device, const QByteArray& payload,
+                                  int chunkSize, int compressionLevel)
+{
+    chunkSize = qMax(chunkSize, 4096);
+    const quint32 chunkCount = quint32((payload.size() + chunkSize - 1) / chunkSize);
+
+    QVector<QByteArray> chunks(int(chunkCount));
+    for (int i = 0; i < chunks.size(); ++i) {
+        // Shallow views into the payload; compression reads them concurrently
+        const qsizetype offset = qsizetype(i) * chunkSize;
+        chunks[i] = QByteArray::fromRawData(payload.constData() + offset,
+                                            qMin<qsizetype>(chunkSize, payload.size() - offset));
+    }
+
+    QtConcurrent::blockingMap(chunks, [compressionLevel](QByteArray& chunk) {
+        chunk = qCompress(chunk, compressionLevel);
+    });
+
+    uchar header[s_headerSize];
+    memcpy(header, s_magic, 4);
+    qToLittleEndian<quint32>(s_version, header + 4);
+    qToLittleEndian<quint32>(quint32(chunkSize), header + 8);
+    qToLittleEndian<quint64>(quint64(payload.size()), header + 12);
+    qToLittleEndian<quint32>(chunkCount, header + 20);
+    if (device->write(reinterpret_cast<const char*>(header), s_headerSize) != s_headerSize) {
+        return false;
+    }
+
+    for (const QByteArray& chunk : std::as_const(chunks)) {
+        uchar size[4];
+        qToLittleEndian<quint32>(quint32(chunk.size()), size);
+        if (device->write(reinterpret_cast<const char*>(size), 4) != 4
+            || device->write(chunk) != chunk.size()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Geo3DCompressedStream::read(QIODevice* device, QByteArray& payload)
+{
+    Reader reader(device);
+    if (!reader.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    payload.clear();
+    payload.resize(qsizetype(reader.payloadSize()));
+    if (reader.read(payload.data(), payload.size()) != payload.size()) {
+        if (!reader.hasError()) {
+            qWarning() << "Compressed scene stream size mismatch";
+        }
+        return false;
+    }
+
+    // Reading past the announced size checks that no data is left over
+    char extra;
+    return reader.read(&extra, 1) == 0 && !reader.hasError();
+}
+
+bool Geo3DCompressedStream::isCompressed(const QByteArray& header)
+{
+    return header.startsWith(QByteArray(s_magic, 4));
+}
+
+Geo3DCompressedStream::Reader::Reader(QIODevice* source, int windowSize)
+    : m_source(source)
+    , m_windowSize(windowSize > 0 ? windowSize : qMax(1, QThreadPool::globalInstance()->maxThreadCount()))
+    , m_payloadSize(0)
+    , m_chunkCount(0)
+    , m_chunksRead(0)
+    , m_delivered(0)
+    , m_windowIndex(0)
+    , m_offset(0)
+    , m_failed(false)
+{
+}
+
+bool Geo3DCompressedStream::Reader::open(OpenMode mode)
+{
+    if ((mode & QIODevice::ReadWrite) != QIODevice::ReadOnly) {
+        qWarning() << "Compressed scene streams can only be read";
+        return false;
+    }
+
+    const QByteArray header = m_source->read(s_headerSize);
+    if (header.size() != s_headerSize || !isCompressed(header)) {
+        qWarning() << "Not a compressed scene stream";
+        return false;
+    }
+
+    const uchar* in = reinterpret_cast<const uchar*>(header.constData());
+    if (qFromLittleEndian<quint32>(in + 4) != s_version) {
+        qWarning() << "Unsupported compressed scene stream version";
+        return false;
+    }
+    m_payloadSize = qFromLittleEndian<quint64>(in + 12);
+    m_chunkCount = qFromLittleEndian<quint32>(in + 20);
+
+    // Chunks are handed out whole, so a second buffer would only add a copy
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+}
+
+bool Geo3DCompressedStream::Reader::isSequential() const
+{
+    return true;
+}
+
+quint64 Geo3DCompressedStream::Reader::payloadSize() const
+{
+    return m_payloadSize;
+}
+
+bool Geo3DCompressedStream::Reader::hasError() const
+{
+    return m_failed;
+}
+
+qint64 Geo3DCompressedStream::Reader::readData(char* data, qint64 maxSize)
+{
+    if (m_failed) {
+        return -1;
+    }
+
+    qint64 copied = 0;
+    while (copied < maxSize) {
+        if (m_windowIndex >= m_window.size()) {
+            if (m_chunksRead == m_chunkCount) {
+                if (m_delivered + quint64(copied) != m_payloadSize) {
+                    fail("Compressed scene stream size mismatch");
+                    return -1;
+                }
+                break;
+            }
+            if (!decompressWindow()) {
+                return -1;
+            }
+        }
+
+        const QByteArray& chunk = m_window[m_windowIndex];
+        const qint64 count = qMin<qint64>(maxSize - copied, chunk.size() - m_offset);
+        memcpy(data + copied, chunk.constData() + m_offset, size_t(count));
+        copied += count;
+        m_offset += count;
+        if (m_offset == chunk.size()) {
+            ++m_windowIndex;
+            m_offset = 0;
+        }
+    }
+
+    m_delivered += quint64(copied);
+    if (m_delivered > m_payloadSize) {
+        fail("Compressed scene stream size mismatch");
+        return -1;
+    }
+    return copied;
+}
+
+qint64 Geo3DCompressedStream::Reader::writeData(const char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+bool Geo3DCompressedStream::Reader::decompressWindow()
+{
+    // Reading is sequential; only decompression is spread over the pool
+    m_window.clear();
+    m_windowIndex = 0;
+    m_offset = 0;
+
+    const quint32 count = qMin(quint32(m_windowSize), m_chunkCount - m_chunksRead);
+    for (quint32 i = 0; i < count; ++i) {
+        const QByteArray sizeBytes = m_source->read(4);
+        if (sizeBytes.size() != 4) {
+            fail("Compressed scene stream is truncated");
+            return false;
+        }
+        const quint32 size = qFromLittleEndian<quint32>(sizeBytes.constData());
+        if (size > s_maxChunkSize) {
+            fail("Compressed scene stream is corrupt");
+            return false;
+        }
+        m_window.append(m_source->read(size));
+        if (quint32(m_window.last().size()) != size) {
+            fail("Compressed scene stream is truncated");
+            return false;
+        }
+    }
+    m_chunksRead += count;
+
+    QtConcurrent::blockingMap(m_window, [](QByteArray& chunk) {
+        chunk = qUncompress(chunk);
+    });
+
+    for (const QByteArray& chunk : std::as_const(m_window)) {
+        if (chunk.isEmpty()) {
+            fail("Compressed scene stream has a corrupt chunk");
+            return false;
+        }
+    }
+    return true;
+}
+
+void Geo3DCompressedStream::Reader::fail(const char* message)
+{
+    qWarning() << message;
+    setErrorString(QString::fromLatin1(message));
+    m_failed = true;
+    m_window.clear();
+    m_windowIndex = 0;
+}
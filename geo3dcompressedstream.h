@@ -0,0 +1,145 @@
+/**
+ * @file geo3dcompressedstream.h
+ * @brief Header file for the Geo3DCompressedStream class
+ */
+
+#ifndef GEO3DCOMPRESSEDSTREAM_H
+#define GEO3DCOMPRESSEDSTREAM_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QVector>
+
+/**
+ * @class Geo3DCompressedStream
+ * @brief zlib compression of a payload in independently compressed chunks
+ *
+ * The payload is split into fixed-size chunks that are compressed with
+ * qCompress() on the global thread pool, so both directions scale with the
+ * number of cores. Chunks are written in payload order, which keeps the
+ * output identical regardless of scheduling.
+ *
+ * Stream layout (all integers little endian):
+ * @code
+ * header  "G3DZ" magic, quint32 version, quint32 chunk size,
+ *         quint64 payload size, quint32 chunk count
+ * chunks  per chunk: quint32 compressed size, qCompress() output
+ * @endcode
+ *
+ * Example usage:
+ * @code
+ * Geo3DCompressedStream::write(&file, jsonBytes);
+ * ...
+ * QByteArray jsonBytes;
+ * if (Geo3DCompressedStream::read(&file, jsonBytes)) { ... }
+ * ...
+ * Geo3DCompressedStream::Reader reader(&file);
+ * if (reader.open(QIODevice::ReadOnly)) { parse(&reader); }
+ * @endcode
+ */
+class Geo3DCompressedStream
+{
+public:
+    /**
+     * @brief Default uncompressed chunk size (1 MiB)
+     */
+    static const int DefaultChunkSize = 1024 * 1024;
+
+    /**
+     * @brief Compresses a payload and writes it to a device
+     *
+     * @param device Open, writable device
+     * @param payload Uncompressed bytes
+     * @param chunkSize Uncompressed bytes per chunk
+     * @param compressionLevel zlib level from 0 (none) to 9 (best), -1 for the default
+     * @return true if every write succeeded
+     */
+    static bool write(QIODevice* device, const QByteArray& payload,
+                      int chunkSize = DefaultChunkSize, int compressionLevel = -1);
+
+    /**
+     * @brief Reads and decompresses a payload written by write()
+     *
+     * Holds the whole payload in memory; use Reader to consume it in
+     * pieces instead.
+     *
+     * @param device Open, readable device positioned at the magic
+     * @param payload Receives the uncompressed bytes
+     * @return true if the stream was valid and every chunk decompressed
+     */
+    static bool read(QIODevice* device, QByteArray& payload);
+
+    /**
+     * @brief Checks whether data starts with the compressed stream magic
+     *
+     * @param header At least the first four bytes of the data
+     * @return true if the bytes identify a compressed stream
+     */
+    static bool isCompressed(const QByteArray& header);
+
+    /**
+     * @brief Sequential read-only device that decompresses a stream as it is read
+     *
+     * Chunks are read and decompressed a window at a time, one chunk per
+     * thread of the global pool, so memory use is bounded by the window
+     * rather than the payload size.
+     */
+    class Reader : public QIODevice
+    {
+    public:
+        /**
+         * @brief Creates a reader on a compressed stream
+         *
+         * @param source Open, readable device positioned at the magic; must outlive the reader
+         * @param windowSize Chunks decompressed together, 0 for one per pool thread
+         */
+        explicit Reader(QIODevice* source, int windowSize = 0);
+
+        /**
+         * @brief Reads and checks the stream header
+         *
+         * @param mode Must be QIODevice::ReadOnly
+         * @return false if the header is invalid or the mode is not read-only
+         */
+        bool open(OpenMode mode) override;
+
+        bool isSequential() const override;
+
+        /**
+         * @brief Gets the uncompressed size announced by the header
+         */
+        quint64 payloadSize() const;
+
+        /**
+         * @brief Tells whether the stream turned out to be corrupt or truncated
+         *
+         * A corrupt stream ends early, which readers see as end of data;
+         * check this afterwards to tell the two apart.
+         */
+        bool hasError() const;
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize) override;
+        qint64 writeData(const char* data, qint64 maxSize) override;
+
+    private:
+        // Reads and decompresses the next window of chunks
+        bool decompressWindow();
+
+        // Marks the stream as corrupt
+        void fail(const char* message);
+
+        QIODevice* m_source;
+        int m_windowSize;
+        quint64 m_payloadSize;
+        quint32 m_chunkCount;
+        quint32 m_chunksRead;
+        quint64 m_delivered;
+        QVector<QByteArray> m_window;
+        int m_windowIndex;
+        qsizetype m_offset;
+        bool m_failed;
+    };
+};
+
+#endif // GEO3DCOMPRESSEDSTREAM_H
@@ -0,0 +1,148 @@
+#include "geo3dentitypool.h"
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DCore/QTransform>
+#include <algorithm>
+
+Geo3DEntityPool::Geo3DEntityPool(int maximumSize)
+    : m_maximumSize(qMax(0, maximumSize))
+{
+}
+
+Geo3DEntityPool::~Geo3DEntityPool()
+{
+    clear();
+}
+
+Geo3DEntityPool::Bundle Geo3DEntityPool::acquire(Qt3DCore::QEntity* parent)
+{
+    while (!m_idle.isEmpty()) {
+        const IdleBundle idle = m_idle.takeLast();
+        if (!idle.entity) {
+            continue;
+        }
+
+        if (idle.entity->parentNode() != parent) {
+            idle.entity->setParent(parent);
+        }
+        idle.entity->setEnabled(true);
+        ++m_statistics.reused;
+
+        Bundle bundle;
+        bundle.entity = idle.entity;
+        bundle.transform = idle.transform;
+        return bundle;
+    }
+
+    ++m_statistics.created;
+    return createBundle(parent);
+}
+
+void Geo3DEntityPool::release(const Bundle& bundle)
+{
+    if (!bundle.entity) {
+        return;
+    }
+
+    if (m_idle.size() >= m_maximumSize) {
+        delete bundle.entity;
+        ++m_statistics.destroyed;
+        return;
+    }
+
+    // Material, geometry and layers belong to the object and the set, not the bundle
+    const Qt3DCore::QComponentVector components = bundle.entity->components();
+    for (Qt3DCore::QComponent* component : components) {
+        if (component != bundle.transform) {
+            bundle.entity->removeComponent(component);
+        }
+    }
+    bundle.entity->setEnabled(false);
+
+    IdleBundle idle;
+    idle.entity = bundle.entity;
+    idle.transform = bundle.transform;
+    m_idle.append(idle);
+    ++m_statistics.returned;
+}
+
+void Geo3DEntityPool::reserve(Qt3DCore::QEntity* parent, int count)
+{
+    pruneDestroyed();
+
+    const int target = qMin(count, m_maximumSize);
+    while (m_idle.size() < target) {
+        const Bundle bundle = createBundle(parent);
+        bundle.entity->setEnabled(false);
+        ++m_statistics.created;
+
+        IdleBundle idle;
+        idle.entity = bundle.entity;
+        idle.transform = bundle.transform;
+        m_idle.append(idle);
+    }
+}
+
+void Geo3DEntityPool::clear()
+{
+    for (const IdleBundle& idle : std::as_const(m_idle)) {
+        if (idle.entity) {
+            delete idle.entity.data();
+            ++m_statistics.destroyed;
+        }
+    }
+    m_idle.clear();
+}
+
+void Geo3DEntityPool::setMaximumSize(int maximumSize)
+{
+    m_maximumSize = qMax(0, maximumSize);
+
+    pruneDestroyed();
+    while (m_idle.size() > m_maximumSize) {
+        delete m_idle.takeLast().entity.data();
+        ++m_statistics.destroyed;
+    }
+}
+
+int Geo3DEntityPool::getMaximumSize() const
+{
+    return m_maximumSize;
+}
+
+int Geo3DEntityPool::idleCount() const
+{
+    int count = 0;
+    for (const IdleBundle& idle : m_idle) {
+        if (idle.entity) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+Geo3DEntityPool::Statistics Geo3DEntityPool::statistics() const
+{
+    return m_statistics;
+}
+
+void Geo3DEntityPool::resetStatistics()
+{
+    m_statistics = Statistics();
+}
+
+Geo3DEntityPool::Bundle Geo3DEntityPool::createBundle(Qt3DCore::QEntity* parent)
+{
+    Bundle bundle;
+    bundle.entity = new Qt3DCore::QEntity(parent);
+    bundle.transform = new Qt3DCore::QTransform();
+    bundle.entity->addComponent(bundle.transform);
+    return bundle;
+}
+
+void Geo3DEntityPool::pruneDestroyed()
+{
+    m_idle.erase(std::remove_if(m_idle.begin(), m_idle.end(),
+                                [](const IdleBundle& idle) { return idle.entity.isNull(); }),
+                 m_idle.end());
+}
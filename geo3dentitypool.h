@@ -0,0 +1,159 @@
+/**
+ * @file geo3dentitypool.h
+ * @brief Header file for the Geo3DEntityPool class
+ */
+
+#ifndef GEO3DENTITYPOOL_H
+#define GEO3DENTITYPOOL_H
+
+#include <QPointer>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+namespace Qt3DCore {
+class QEntity;
+class QTransform;
+}
+QT_END_NAMESPACE
+
+/**
+ * @class Geo3DEntityPool
+ * @brief Recycles the entity and transform of objects that leave the scene
+ *
+ * Every entity and component is a Qt3D node with a backend counterpart, so
+ * building them for objects that are regenerated, paged in or filtered out
+ * costs node creation and destruction on both sides. With a pool set on the
+ * object set, objects check out a bundle of an entity and its transform
+ * instead, and return it when they are removed or deleted. A returned bundle
+ * stays in the scene, disabled and stripped of its material, geometry and
+ * layers, until it is checked out again. Materials and meshes are already
+ * shared through the set's registries and are not pooled.
+ *
+ * The pool must outlive the bundles checked out from it; release the set's
+ * entities (Geo3DObjectSet::releaseEntities()) before deleting it.
+ *
+ * Example usage:
+ * @code
+ * Geo3DEntityPool pool;
+ * objectSet.setEntityPool(&pool);
+ * pool.reserve(rootEntity, 256);
+ * objectSet.createEntities(rootEntity);
+ * objectSet.removeObject("borehole_1");   // its bundle goes back to the pool
+ * @endcode
+ */
+class Geo3DEntityPool
+{
+public:
+    /**
+     * @brief Default number of idle bundles kept; further returns are deleted
+     */
+    static const int DefaultMaximumSize = 10000;
+
+    /**
+     * @brief An entity with its transform attached
+     */
+    struct Bundle
+    {
+        Qt3DCore::QEntity* entity = nullptr;
+        Qt3DCore::QTransform* transform = nullptr;
+    };
+
+    /**
+     * @brief Counters since construction or the last resetStatistics()
+     */
+    struct Statistics
+    {
+        int created = 0;
+        int reused = 0;
+        int returned = 0;
+        int destroyed = 0;
+    };
+
+    /**
+     * @brief Creates an empty pool
+     *
+     * @param maximumSize Number of idle bundles to keep
+     */
+    explicit Geo3DEntityPool(int maximumSize = DefaultMaximumSize);
+
+    /**
+     * @brief Destructor
+     *
+     * Deletes the idle bundles. Bundles still checked out are left to their objects.
+     */
+    ~Geo3DEntityPool();
+
+    Geo3DEntityPool(const Geo3DEntityPool&) = delete;
+    Geo3DEntityPool& operator=(const Geo3DEntityPool&) = delete;
+
+    /**
+     * @brief Checks out a bundle
+     *
+     * Reuses an idle bundle, moved under the parent if needed, or creates a new one.
+     *
+     * @param parent Parent of the entity
+     * @return Enabled entity with its transform as the only component
+     */
+    Bundle acquire(Qt3DCore::QEntity* parent);
+
+    /**
+     * @brief Returns a bundle to the pool
+     *
+     * Removes every component except the transform and disables the entity.
+     * The bundle is deleted instead when the pool is full.
+     *
+     * @param bundle Bundle from acquire()
+     */
+    void release(const Bundle& bundle);
+
+    /**
+     * @brief Builds idle bundles ahead of use
+     *
+     * @param parent Parent of the new entities
+     * @param count Number of idle bundles to have afterwards, limited by the maximum size
+     */
+    void reserve(Qt3DCore::QEntity* parent, int count);
+
+    /**
+     * @brief Deletes all idle bundles
+     */
+    void clear();
+
+    /**
+     * @brief Sets the number of idle bundles to keep, deleting any excess
+     *
+     * @param maximumSize Number of bundles
+     */
+    void setMaximumSize(int maximumSize);
+    int getMaximumSize() const;
+
+    /**
+     * @brief Gets the number of bundles ready to be checked out
+     *
+     * Bundles destroyed with their scene are not counted.
+     *
+     * @return Number of idle bundles
+     */
+    int idleCount() const;
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct IdleBundle
+    {
+        QPointer<Qt3DCore::QEntity> entity;
+        Qt3DCore::QTransform* transform = nullptr;
+    };
+
+    static Bundle createBundle(Qt3DCore::QEntity* parent);
+
+    // Drops bundles whose entities were deleted together with their scene
+    void pruneDestroyed();
+
+    QVector<IdleBundle> m_idle;
+    int m_maximumSize;
+    Statistics m_statistics;
+};
+
+#endif // GEO3DENTITYPOOL_H
@@ -0,0 +1,158 @@
+#include "geo3dgeometryregistry.h"
+
+#include <Qt3DCore/QNode>
+#include <Qt3DRender/QGeometryRenderer>
+
+Geo3DGeometryRegistry::Geo3DGeometryRegistry()
+    : m_keepUnused(false)
+{
+}
+
+Geo3DGeometryRegistry::~Geo3DGeometryRegistry()
+{
+    clear();
+}
+
+Qt3DRender::QGeometryRenderer* Geo3DGeometryRegistry::acquire(const QByteArray& key, const GeometryFactory& factory)
+{
+    auto it = m_entries.find(key);
+    if (it != m_entries.end() && it->renderer) {
+        ++it->refCount;
+        return it->renderer;
+    }
+
+    // Either a new shape or the node was destroyed with its scene
+    if (it != m_entries.end()) {
+        // The address may already belong to a node created since
+        auto keyIt = m_keys.find(it->address);
+        if (keyIt != m_keys.end() && keyIt.value() == key) {
+            m_keys.erase(keyIt);
+        }
+        m_entries.erase(it);
+    }
+
+    Qt3DRender::QGeometryRenderer* renderer = factory();
+    if (!renderer) {
+        return nullptr;
+    }
+    if (m_parentNode) {
+        renderer->setParent(m_parentNode.data());
+    }
+
+    Entry entry;
+    entry.renderer = renderer;
+    entry.address = renderer;
+    entry.refCount = 1;
+    m_entries.insert(key, entry);
+    m_keys.insert(renderer, key);
+
+    return renderer;
+}
+
+void Geo3DGeometryRegistry::release(Qt3DRender::QGeometryRenderer* renderer)
+{
+    auto keyIt = m_keys.find(renderer);
+    if (keyIt == m_keys.end()) {
+        return;
+    }
+
+    auto it = m_entries.find(keyIt.value());
+    if (it == m_entries.end() || it->renderer != renderer) {
+        m_keys.erase(keyIt);
+        return;
+    }
+
+    // Unused nodes may be kept for objects that come back
+    if (--it->refCount > 0 || m_keepUnused) {
+        return;
+    }
+
+    m_keys.erase(keyIt);
+    Qt3DRender::QGeometryRenderer* node = it->renderer;
+    m_entries.erase(it);
+    delete node;
+}
+
+int Geo3DGeometryRegistry::geometryCount() const
+{
+    return m_entries.size();
+}
+
+int Geo3DGeometryRegistry::referenceCount(Qt3DRender::QGeometryRenderer* renderer) const
+{
+    auto keyIt = m_keys.constFind(renderer);
+    if (keyIt == m_keys.constEnd()) {
+        return 0;
+    }
+
+    auto it = m_entries.constFind(keyIt.value());
+    return (it != m_entries.constEnd()) ? it->refCount : 0;
+}
+
+void Geo3DGeometryRegistry::setParentNode(Qt3DCore::QNode* parent)
+{
+    m_parentNode = parent;
+}
+
+Qt3DCore::QNode* Geo3DGeometryRegistry::getParentNode() const
+{
+    return m_parentNode;
+}
+
+void Geo3DGeometryRegistry::setKeepUnused(bool keep)
+{
+    m_keepUnused = keep;
+    if (!keep) {
+        purgeUnused();
+    }
+}
+
+bool Geo3DGeometryRegistry::getKeepUnused() const
+{
+    return m_keepUnused;
+}
+
+void Geo3DGeometryRegistry::purgeUnused()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->refCount > 0) {
+            ++it;
+            continue;
+        }
+        Qt3DRender::QGeometryRenderer* node = it->renderer;
+        m_keys.remove(node);
+        it = m_entries.erase(it);
+        delete node;
+    }
+}
+
+void Geo3DGeometryRegistry::pruneDestroyed()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->renderer) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+        }
+    }
+
+    // The reverse lookup still holds the addresses of the destroyed nodes
+    for (auto it = m_keys.begin(); it != m_keys.end();) {
+        auto entry = m_entries.constFind(it.value());
+        if (entry != m_entries.constEnd() && entry->renderer == it.key()) {
+            ++it;
+        } else {
+            it = m_keys.erase(it);
+        }
+    }
+}
+
+void Geo3DGeometryRegistry::clear()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        // Nodes parented to a destroyed scene are already gone
+        delete it->renderer.data();
+    }
+    m_entries.clear();
+    m_keys.clear();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file geo3dgeometryregistry.h
+ * @brief Header file for the Geo3DGeometryRegistry class
+ */
+
+#ifndef GEO3DGEOMETRYREGISTRY_H
+#define GEO3DGEOMETRYREGISTRY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QPointer>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+namespace Qt3DCore {
+class QNode;
+}
+namespace Qt3DRender {
+class QGeometryRenderer;
+}
+QT_END_NAMESPACE
+
+/**
+ * @class Geo3DGeometryRegistry
+ * @brief Interns Qt3D geometry so objects with identical shape parameters share one mesh
+ *
+ * Counterpart of Geo3DMaterialRegistry for geometry. Objects identify their
+ * shape with Geo3DObject::getShapeKey(); all objects with the same key use a
+ * single, reference-counted QGeometryRenderer, so a scene with thousands of
+ * identical boreholes tessellates and uploads one mesh. An object whose shape
+ * changes releases its renderer and acquires the one for the new key.
+ *
+ * Example usage:
+ * @code
+ * Qt3DRender::QGeometryRenderer* renderer = registry.acquire(key, [&]() { return createGeometry(); });
+ * entity->addComponent(renderer);
+ * ...
+ * entity->removeComponent(renderer);
+ * registry.release(renderer);
+ * @endcode
+ */
+class Geo3DGeometryRegistry
+{
+public:
+    // Builds the renderer for a key that is not interned yet
+    typedef std::function<Qt3DRender::QGeometryRenderer*()> GeometryFactory;
+
+    /**
+     * @brief Default constructor
+     *
+     * Creates an empty registry without a parent node.
+     */
+    explicit Geo3DGeometryRegistry();
+
+    /**
+     * @brief Destructor
+     *
+     * Deletes all geometry renderers that are still alive.
+     */
+    ~Geo3DGeometryRegistry();
+
+    Geo3DGeometryRegistry(const Geo3DGeometryRegistry&) = delete;
+    Geo3DGeometryRegistry& operator=(const Geo3DGeometryRegistry&) = delete;
+
+    /**
+     * @brief Returns the shared renderer for a shape key, creating it on first use
+     *
+     * Each call adds a reference that must be returned with release().
+     *
+     * @param key Shape key from Geo3DObject::getShapeKey()
+     * @param factory Creates the renderer when the key is new
+     * @return Shared renderer, or nullptr if the factory produced none
+     */
+    Qt3DRender::QGeometryRenderer* acquire(const QByteArray& key, const GeometryFactory& factory);
+
+    /**
+     * @brief Drops one reference to a shared renderer
+     *
+     * The renderer is deleted when its last reference is released, unless
+     * unused renderers are kept (see setKeepUnused()).
+     *
+     * @param renderer Renderer previously returned by acquire()
+     */
+    void release(Qt3DRender::QGeometryRenderer* renderer);
+
+    /**
+     * @brief Gets the number of distinct renderers currently alive
+     */
+    int geometryCount() const;
+
+    /**
+     * @brief Gets the number of objects sharing a renderer
+     *
+     * @param renderer Renderer to look up
+     * @return Reference count, or 0 if the renderer is unknown
+     */
+    int referenceCount(Qt3DRender::QGeometryRenderer* renderer) const;
+
+    /**
+     * @brief Keeps renderers alive after their last reference is released
+     *
+     * Objects that are removed and added again, e.g. while paging through a
+     * site, then find their renderer still interned instead of building it
+     * again. Turning this off deletes the unused ones.
+     *
+     * @param keep true to keep unused renderers until purgeUnused() or clear()
+     */
+    void setKeepUnused(bool keep);
+    bool getKeepUnused() const;
+
+    /**
+     * @brief Deletes the renderers that no object references
+     */
+    void purgeUnused();
+
+    /**
+     * @brief Forgets the renderers that were destroyed with their scene
+     *
+     * Objects whose entity died with the scene cannot release their
+     * references, so those entries are dropped here regardless of their
+     * reference count. Live entries are kept.
+     */
+    void pruneDestroyed();
+
+    /**
+     * @brief Sets the node that owns newly created renderers
+     *
+     * Shared renderers must not be owned by any single entity, otherwise
+     * deleting that entity would destroy a mesh other entities still use.
+     *
+     * @param parent Scene node under which renderers are kept
+     */
+    void setParentNode(Qt3DCore::QNode* parent);
+
+    /**
+     * @brief Gets the node that owns newly created renderers
+     */
+    Qt3DCore::QNode* getParentNode() const;
+
+    /**
+     * @brief Deletes all renderers and forgets all references
+     */
+    void clear();
+
+private:
+    struct Entry
+    {
+        QPointer<Qt3DRender::QGeometryRenderer> renderer;
+        // Key in m_keys, still known after the node was destroyed
+        Qt3DRender::QGeometryRenderer* address;
+        int refCount;
+    };
+
+    /**
+     * @brief Interned renderers keyed by shape key
+     */
+    QHash<QByteArray, Entry> m_entries;
+
+    /**
+     * @brief Reverse lookup from renderer to its shape key
+     */
+    QHash<Qt3DRender::QGeometryRenderer*, QByteArray> m_keys;
+
+    /**
+     * @brief Owner of newly created renderers
+     */
+    QPointer<Qt3DCore::QNode> m_parentNode;
+
+    /**
+     * @brief Whether renderers outlive their last reference
+     */
+    bool m_keepUnused;
+};
+
+#endif // GEO3DGEOMETRYREGISTRY_H
@@ -0,0 +1,419 @@
+#include "geo3djsonstreamreader.h"
+
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonObject>
+
+Geo3DJsonStreamReader::Geo3DJsonStreamReader(QIODevice* device, int chunkSize)
+    : m_device(device)
+    , m_chunkSize(qMax(chunkSize, 16))
+    , m_position(0)
+    , m_consumed(0)
+    , m_atEnd(false)
+    , m_topState(ExpectValue)
+    , m_tokenType(NoToken)
+{
+}
+
+Geo3DJsonStreamReader::TokenType Geo3DJsonStreamReader::readNext()
+{
+    if (m_tokenType == Invalid || m_tokenType == EndDocument) {
+        return m_tokenType;
+    }
+
+    if (!skipWhitespace()) {
+        if (m_topState == Done && m_stack.isEmpty()) {
+            return m_tokenType = EndDocument;
+        }
+        return setError(QStringLiteral("Unexpected end of data"));
+    }
+
+    if (m_stack.isEmpty()) {
+        if (m_topState == Done) {
+            return setError(QStringLiteral("Unexpected data after the top-level value"));
+        }
+        return readValueStart();
+    }
+
+    Container& container = m_stack.last();
+    char c = peekChar();
+
+    switch (container.state) {
+    case ExpectNameOrEnd:
+    case ExpectName:
+        if (c == '}' && container.state == ExpectNameOrEnd) {
+            takeChar();
+            return closeContainer(true);
+        }
+        if (c != '"') {
+            return setError(QStringLiteral("Expected member name"));
+        }
+        if (!parseString(m_name)) {
+            return m_tokenType;
+        }
+        if (!skipWhitespace() || takeChar() != ':') {
+            return setError(QStringLiteral("Expected ':' after member name"));
+        }
+        m_stack.last().state = ExpectValue;
+        return m_tokenType = Name;
+
+    case ExpectValueOrEnd:
+        if (c == ']') {
+            takeChar();
+            return closeContainer(false);
+        }
+        return readValueStart();
+
+    case ExpectValue:
+        return readValueStart();
+
+    case ExpectCommaOrEnd:
+        takeChar();
+        if (c == ',') {
+            container.state = container.isObject ? ExpectName : ExpectValue;
+            return readNext();
+        }
+        if (c == '}' && container.isObject) {
+            return closeContainer(true);
+        }
+        if (c == ']' && !container.isObject) {
+            return closeContainer(false);
+        }
+        return setError(QStringLiteral("Expected ',' or end of container"));
+
+    case Done:
+        break;
+    }
+
+    return setError(QStringLiteral("Invalid reader state"));
+}
+
+Geo3DJsonStreamReader::TokenType Geo3DJsonStreamReader::tokenType() const
+{
+    return m_tokenType;
+}
+
+QString Geo3DJsonStreamReader::name() const
+{
+    return m_name;
+}
+
+QJsonValue Geo3DJsonStreamReader::value() const
+{
+    return m_value;
+}
+
+QJsonValue Geo3DJsonStreamReader::readValue()
+{
+    readNext();
+    return readCurrentValue();
+}
+
+QJsonValue Geo3DJsonStreamReader::readCurrentValue()
+{
+    switch (m_tokenType) {
+    case Value:
+        return m_value;
+
+    case StartObject: {
+        QJsonObject object;
+        while (readNext() == Name) {
+            QString key = m_name;
+            QJsonValue member = readValue();
+            if (m_tokenType == Invalid) {
+                return QJsonValue(QJsonValue::Undefined);
+            }
+            object.insert(key, member);
+        }
+        if (m_tokenType != EndObject) {
+            return QJsonValue(QJsonValue::Undefined);
+        }
+        return object;
+    }
+
+    case StartArray: {
+        QJsonArray array;
+        for (;;) {
+            TokenType token = readNext();
+            if (token == EndArray) {
+                break;
+            }
+            QJsonValue element = readCurrentValue();
+            if (m_tokenType == Invalid) {
+                return QJsonValue(QJsonValue::Undefined);
+            }
+            array.append(element);
+        }
+        return array;
+    }
+
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+void Geo3DJsonStreamReader::skipValue()
+{
+    int depth = 0;
+    do {
+        switch (readNext()) {
+        case StartObject:
+        case StartArray:
+            ++depth;
+            break;
+        case EndObject:
+        case EndArray:
+            --depth;
+            break;
+        case Invalid:
+        case EndDocument:
+            return;
+        default:
+            break;
+        }
+    } while (depth > 0);
+}
+
+bool Geo3DJsonStreamReader::hasError() const
+{
+    return m_tokenType == Invalid;
+}
+
+QString Geo3DJsonStreamReader::errorString() const
+{
+    return m_error;
+}
+
+bool Geo3DJsonStreamReader::fill()
+{
+    if (m_position < m_buffer.size()) {
+        return true;
+    }
+    if (m_atEnd || !m_device) {
+        return false;
+    }
+
+    m_consumed += m_buffer.size();
+    m_buffer = m_device->read(m_chunkSize);
+    m_position = 0;
+
+    if (m_buffer.isEmpty()) {
+        m_atEnd = true;
+        return false;
+    }
+    return true;
+}
+
+bool Geo3DJsonStreamReader::skipWhitespace()
+{
+    for (;;) {
+        if (!fill()) {
+            return false;
+        }
+        char c = m_buffer.at(m_position);
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            return true;
+        }
+        ++m_position;
+    }
+}
+
+char Geo3DJsonStreamReader::peekChar() const
+{
+    return m_buffer.at(m_position);
+}
+
+char Geo3DJsonStreamReader::takeChar()
+{
+    if (!fill()) {
+        return '\0';
+    }
+    return m_buffer.at(m_position++);
+}
+
+Geo3DJsonStreamReader::TokenType Geo3DJsonStreamReader::readValueStart()
+{
+    char c = peekChar();
+
+    if (c == '{' || c == '[') {
+        takeChar();
+        // The parent sees the container as one value
+        valueCompleted();
+        Container container;
+        container.isObject = (c == '{');
+        container.state = container.isObject ? ExpectNameOrEnd : ExpectValueOrEnd;
+        m_stack.append(container);
+        return m_tokenType = container.isObject ? StartObject : StartArray;
+    }
+
+    if (c == '"') {
+        QString string;
+        if (!parseString(string)) {
+            return m_tokenType;
+        }
+        m_value = string;
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        double number = 0.0;
+        if (!parseNumber(number)) {
+            return m_tokenType;
+        }
+        m_value = number;
+    } else if (c == 't') {
+        if (!parseLiteral("true")) {
+            return m_tokenType;
+        }
+        m_value = true;
+    } else if (c == 'f') {
+        if (!parseLiteral("false")) {
+            return m_tokenType;
+        }
+        m_value = false;
+    } else if (c == 'n') {
+        if (!parseLiteral("null")) {
+            return m_tokenType;
+        }
+        m_value = QJsonValue(QJsonValue::Null);
+    } else {
+        return setError(QStringLiteral("Unexpected character '%1'").arg(QLatin1Char(c)));
+    }
+
+    valueCompleted();
+    return m_tokenType = Value;
+}
+
+Geo3DJsonStreamReader::TokenType Geo3DJsonStreamReader::closeContainer(bool isObject)
+{
+    m_stack.removeLast();
+    return m_tokenType = isObject ? EndObject : EndArray;
+}
+
+void Geo3DJsonStreamReader::valueCompleted()
+{
+    if (m_stack.isEmpty()) {
+        m_topState = Done;
+    } else {
+        m_stack.last().state = ExpectCommaOrEnd;
+    }
+}
+
+bool Geo3DJsonStreamReader::parseString(QString& result)
+{
+    takeChar(); // Opening quote
+
+    QByteArray utf8;
+    QString pending; // Decoded \u escapes not yet merged into utf8
+    for (;;) {
+        if (!fill()) {
+            setError(QStringLiteral("Unterminated string"));
+            return false;
+        }
+
+        // Copy the run of plain bytes in one go
+        const char* data = m_buffer.constData();
+        int start = m_position;
+        while (m_position < m_buffer.size() && data[m_position] != '"' && data[m_position] != '\\') {
+            ++m_position;
+        }
+        if (m_position > start) {
+            if (!pending.isEmpty()) {
+                utf8 += pending.toUtf8();
+                pending.clear();
+            }
+            utf8.append(data + start, m_position - start);
+        }
+        if (m_position >= m_buffer.size()) {
+            continue;
+        }
+
+        char c = takeChar();
+        if (c == '"') {
+            break;
+        }
+
+        // Escape sequence
+        char escape = takeChar();
+        char decoded = 0;
+        switch (escape) {
+        case '"': decoded = '"'; break;
+        case '\\': decoded = '\\'; break;
+        case '/': decoded = '/'; break;
+        case 'b': decoded = '\b'; break;
+        case 'f': decoded = '\f'; break;
+        case 'n': decoded = '\n'; break;
+        case 'r': decoded = '\r'; break;
+        case 't': decoded = '\t'; break;
+        case 'u': {
+            char hex[5] = {0, 0, 0, 0, 0};
+            for (int i = 0; i < 4; ++i) {
+                hex[i] = takeChar();
+            }
+            bool ok = false;
+            ushort unit = QByteArray(hex, 4).toUShort(&ok, 16);
+            if (!ok) {
+                setError(QStringLiteral("Invalid \\u escape"));
+                return false;
+            }
+            // Surrogate pairs arrive as two escapes, so collect UTF-16 first
+            pending.append(QChar(unit));
+            continue;
+        }
+        default:
+            setError(QStringLiteral("Invalid escape sequence"));
+            return false;
+        }
+
+        if (!pending.isEmpty()) {
+            utf8 += pending.toUtf8();
+            pending.clear();
+        }
+        utf8.append(decoded);
+    }
+
+    if (!pending.isEmpty()) {
+        utf8 += pending.toUtf8();
+    }
+    result = QString::fromUtf8(utf8);
+    return true;
+}
+
+bool Geo3DJsonStreamReader::parseNumber(double& result)
+{
+    QByteArray text;
+    for (;;) {
+        if (!fill()) {
+            break;
+        }
+        char c = peekChar();
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            text.append(c);
+            ++m_position;
+        } else {
+            break;
+        }
+    }
+
+    bool ok = false;
+    result = text.toDouble(&ok);
+    if (!ok) {
+        setError(QStringLiteral("Invalid number '%1'").arg(QString::fromLatin1(text)));
+        return false;
+    }
+    return true;
+}
+
+bool Geo3DJsonStreamReader::parseLiteral(const char* literal)
+{
+    for (const char* p = literal; *p; ++p) {
+        if (takeChar() != *p) {
+            setError(QStringLiteral("Invalid literal, expected '%1'").arg(QLatin1String(literal)));
+            return false;
+        }
+    }
+    return true;
+}
+
+Geo3DJsonStreamReader::TokenType Geo3DJsonStreamReader::setError(const QString& message)
+{
+    m_error = QStringLiteral("%1 at offset %2").arg(message).arg(m_consumed + m_position);
+    return m_tokenType = Invalid;
+}
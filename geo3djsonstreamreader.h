@@ -0,0 +1,164 @@
+/**
+ * @file geo3djsonstreamreader.h
+ * @brief Header file for the Geo3DJsonStreamReader class
+ */
+
+#ifndef GEO3DJSONSTREAMREADER_H
+#define GEO3DJSONSTREAMREADER_H
+
+#include <QByteArray>
+#include <QJsonValue>
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+/**
+ * @class Geo3DJsonStreamReader
+ * @brief Pull-style JSON tokenizer that reads a QIODevice in fixed-size chunks
+ *
+ * QJsonDocument needs the whole file in memory and builds the complete DOM
+ * before any object can be created. This reader walks the document token by
+ * token instead, so a caller can materialize one record at a time with
+ * readValue() and discard it before reading the next. Peak memory is bounded
+ * by the chunk size plus the largest single record.
+ *
+ * Example usage:
+ * @code
+ * Geo3DJsonStreamReader reader(&file);
+ * if (reader.readNext() == Geo3DJsonStreamReader::StartObject) {
+ *     while (reader.readNext() == Geo3DJsonStreamReader::Name) {
+ *         QString key = reader.name();
+ *         QJsonValue value = reader.readValue();
+ *         ...
+ *     }
+ * }
+ * if (reader.hasError()) qWarning() << reader.errorString();
+ * @endcode
+ */
+class Geo3DJsonStreamReader
+{
+public:
+    /**
+     * @brief Kinds of token returned by readNext()
+     */
+    enum TokenType {
+        NoToken,      ///< Nothing has been read yet
+        StartObject,  ///< '{'
+        EndObject,    ///< '}'
+        StartArray,   ///< '['
+        EndArray,     ///< ']'
+        Name,         ///< Member name inside an object, available from name()
+        Value,        ///< String, number, boolean or null, available from value()
+        EndDocument,  ///< The top-level value has been fully read
+        Invalid       ///< Syntax or device error, see errorString()
+    };
+
+    /**
+     * @brief Creates a reader for an open, readable device
+     *
+     * @param device Device to read from; the reader does not take ownership
+     * @param chunkSize Number of bytes requested from the device per read
+     */
+    explicit Geo3DJsonStreamReader(QIODevice* device, int chunkSize = 64 * 1024);
+
+    /**
+     * @brief Advances to the next token
+     *
+     * @return Type of the token that was read
+     */
+    TokenType readNext();
+
+    /**
+     * @brief Gets the type of the current token
+     */
+    TokenType tokenType() const;
+
+    /**
+     * @brief Gets the member name of the current Name token
+     */
+    QString name() const;
+
+    /**
+     * @brief Gets the scalar value of the current Value token
+     */
+    QJsonValue value() const;
+
+    /**
+     * @brief Reads the next complete value, including nested objects and arrays
+     *
+     * Typically called right after a Name token to materialize one member.
+     *
+     * @return The value, or an undefined QJsonValue on error or at the end of a container
+     */
+    QJsonValue readValue();
+
+    /**
+     * @brief Skips the next complete value without materializing it
+     */
+    void skipValue();
+
+    /**
+     * @brief Checks if a syntax or device error occurred
+     */
+    bool hasError() const;
+
+    /**
+     * @brief Gets a description of the error, including the byte offset
+     */
+    QString errorString() const;
+
+private:
+    // What the innermost container expects next
+    enum State {
+        ExpectValue,          // Top level, after ':' or after ',' in an array
+        ExpectValueOrEnd,     // Right after '['
+        ExpectNameOrEnd,      // Right after '{'
+        ExpectName,           // After ',' in an object
+        ExpectCommaOrEnd,     // After a complete member or element
+        Done                  // Top-level value complete
+    };
+
+    struct Container
+    {
+        bool isObject;
+        State state;
+    };
+
+    // Buffered character access
+    bool fill();
+    bool skipWhitespace();
+    char peekChar() const;
+    char takeChar();
+
+    QJsonValue readCurrentValue();
+    TokenType readValueStart();
+    TokenType closeContainer(bool isObject);
+    void valueCompleted();
+
+    bool parseString(QString& result);
+    bool parseNumber(double& result);
+    bool parseLiteral(const char* literal);
+
+    TokenType setError(const QString& message);
+
+    QIODevice* m_device;
+    int m_chunkSize;
+
+    QByteArray m_buffer;
+    int m_position;
+    qint64 m_consumed;
+    bool m_atEnd;
+
+    QVector<Container> m_stack;
+    State m_topState;
+
+    TokenType m_tokenType;
+    QString m_name;
+    QJsonValue m_value;
+    QString m_error;
+};
+
+#endif // GEO3DJSONSTREAMREADER_H
@@ -0,0 +1,250 @@
+#include "geo3dmaterialregistry.h"
+
+#include <Qt3DCore/QNode>
+#include <Qt3DRender/QMaterial>
+#include <Qt3DRender/QEffect>
+#include <Qt3DRender/QTechnique>
+#include <Qt3DRender/QRenderPass>
+#include <Qt3DRender/QCullFace>
+#include <Qt3DRender/QDepthTest>
+#include <Qt3DExtras/QPhongMaterial>
+#include <Qt3DExtras/QPhongAlphaMaterial>
+
+size_t qHash(const Geo3DMaterialKey& key, size_t seed)
+{
+    return qHashMulti(seed, key.diffuse, key.ambient, key.specular, key.shininess, key.opacity,
+                      key.translucent, key.cullBackFaces);
+}
+
+Geo3DMaterialRegistry::Geo3DMaterialRegistry()
+    : m_keepUnused(false)
+{
+}
+
+Geo3DMaterialRegistry::~Geo3DMaterialRegistry()
+{
+    clear();
+}
+
+Geo3DMaterialKey Geo3DMaterialRegistry::makeKey(const QColor& diffuse, const QColor& ambient,
+                                                const QColor& specular, float shininess, float opacity,
+                                                bool translucent, bool cullBackFaces)
+{
+    Geo3DMaterialKey key;
+    key.diffuse = diffuse.rgba();
+    key.ambient = ambient.rgba();
+    key.specular = specular.rgba();
+    key.shininess = shininess;
+    key.opacity = opacity;
+    key.translucent = translucent;
+    key.cullBackFaces = cullBackFaces;
+    return key;
+}
+
+Qt3DRender::QMaterial* Geo3DMaterialRegistry::createMaterial(const Geo3DMaterialKey& key, Qt3DCore::QNode* parent)
+{
+    Qt3DRender::QMaterial* material = nullptr;
+    if (key.translucent) {
+        // QPhongAlphaMaterial already blends and disables depth writes
+        material = new Qt3DExtras::QPhongAlphaMaterial(parent);
+    } else {
+        material = new Qt3DExtras::QPhongMaterial(parent);
+    }
+
+    // Each Phong material instance owns its effect, so its passes can be configured per key
+    const QList<Qt3DRender::QTechnique*> techniques = material->effect()->techniques();
+    for (Qt3DRender::QTechnique* technique : techniques) {
+        const QList<Qt3DRender::QRenderPass*> passes = technique->renderPasses();
+        for (Qt3DRender::QRenderPass* pass : passes) {
+            Qt3DRender::QCullFace* cullFace = new Qt3DRender::QCullFace(pass);
+            cullFace->setMode(key.cullBackFaces ? Qt3DRender::QCullFace::Back
+                                                : Qt3DRender::QCullFace::NoCulling);
+            pass->addRenderState(cullFace);
+
+            if (!key.translucent) {
+                Qt3DRender::QDepthTest* depthTest = new Qt3DRender::QDepthTest(pass);
+                depthTest->setDepthFunction(Qt3DRender::QDepthTest::Less);
+                pass->addRenderState(depthTest);
+            }
+        }
+    }
+
+    applyProperties(material, key);
+    return material;
+}
+
+void Geo3DMaterialRegistry::applyProperties(Qt3DRender::QMaterial* material, const Geo3DMaterialKey& key)
+{
+    if (Qt3DExtras::QPhongAlphaMaterial* alphaMaterial = qobject_cast<Qt3DExtras::QPhongAlphaMaterial*>(material)) {
+        QColor diffuse = QColor::fromRgba(key.diffuse);
+        diffuse.setAlphaF(key.opacity);
+
+        QColor ambient = QColor::fromRgba(key.ambient);
+        ambient.setAlphaF(key.opacity);
+
+        alphaMaterial->setDiffuse(diffuse);
+        alphaMaterial->setAmbient(ambient);
+        alphaMaterial->setSpecular(QColor::fromRgba(key.specular));
+        alphaMaterial->setShininess(key.shininess);
+        // The shader blends with the alpha property, not the color alpha
+        alphaMaterial->setAlpha(key.opacity);
+    } else if (Qt3DExtras::QPhongMaterial* phongMaterial = qobject_cast<Qt3DExtras::QPhongMaterial*>(material)) {
+        phongMaterial->setDiffuse(QColor::fromRgba(key.diffuse));
+        phongMaterial->setAmbient(QColor::fromRgba(key.ambient));
+        phongMaterial->setSpecular(QColor::fromRgba(key.specular));
+        phongMaterial->setShininess(key.shininess);
+    }
+}
+
+Qt3DRender::QMaterial* Geo3DMaterialRegistry::acquire(const Geo3DMaterialKey& key)
+{
+    auto it = m_entries.find(key);
+    if (it != m_entries.end() && it->material) {
+        ++it->refCount;
+        return it->material;
+    }
+
+    // Either a new combination or the node was destroyed with its scene
+    if (it != m_entries.end()) {
+        // The address may already belong to a node created since
+        auto keyIt = m_keys.find(it->address);
+        if (keyIt != m_keys.end() && keyIt.value() == key) {
+            m_keys.erase(keyIt);
+        }
+        m_entries.erase(it);
+    }
+
+    Qt3DRender::QMaterial* material = createMaterial(key, m_parentNode);
+
+    Entry entry;
+    entry.material = material;
+    entry.address = material;
+    entry.refCount = 1;
+    m_entries.insert(key, entry);
+    m_keys.insert(material, key);
+
+    return material;
+}
+
+void Geo3DMaterialRegistry::release(Qt3DRender::QMaterial* material)
+{
+    auto keyIt = m_keys.find(material);
+    if (keyIt == m_keys.end()) {
+        return;
+    }
+
+    auto it = m_entries.find(keyIt.value());
+    if (it == m_entries.end() || it->material != material) {
+        m_keys.erase(keyIt);
+        return;
+    }
+
+    // Unused nodes may be kept for objects that come back
+    if (--it->refCount > 0 || m_keepUnused) {
+        return;
+    }
+
+    m_keys.erase(keyIt);
+    Qt3DRender::QMaterial* node = it->material;
+    m_entries.erase(it);
+    delete node;
+}
+
+bool Geo3DMaterialRegistry::contains(Qt3DRender::QMaterial* material) const
+{
+    return m_keys.contains(material);
+}
+
+bool Geo3DMaterialRegistry::keyOf(Qt3DRender::QMaterial* material, Geo3DMaterialKey& key) const
+{
+    auto it = m_keys.constFind(material);
+    if (it == m_keys.constEnd()) {
+        return false;
+    }
+    key = it.value();
+    return true;
+}
+
+int Geo3DMaterialRegistry::materialCount() const
+{
+    return m_entries.size();
+}
+
+int Geo3DMaterialRegistry::referenceCount(Qt3DRender::QMaterial* material) const
+{
+    auto keyIt = m_keys.constFind(material);
+    if (keyIt == m_keys.constEnd()) {
+        return 0;
+    }
+
+    auto it = m_entries.constFind(keyIt.value());
+    return (it != m_entries.constEnd()) ? it->refCount : 0;
+}
+
+void Geo3DMaterialRegistry::setParentNode(Qt3DCore::QNode* parent)
+{
+    m_parentNode = parent;
+}
+
+Qt3DCore::QNode* Geo3DMaterialRegistry::getParentNode() const
+{
+    return m_parentNode;
+}
+
+void Geo3DMaterialRegistry::setKeepUnused(bool keep)
+{
+    m_keepUnused = keep;
+    if (!keep) {
+        purgeUnused();
+    }
+}
+
+bool Geo3DMaterialRegistry::getKeepUnused() const
+{
+    return m_keepUnused;
+}
+
+void Geo3DMaterialRegistry::purgeUnused()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->refCount > 0) {
+            ++it;
+            continue;
+        }
+        Qt3DRender::QMaterial* node = it->material;
+        m_keys.remove(node);
+        it = m_entries.erase(it);
+        delete node;
+    }
+}
+
+void Geo3DMaterialRegistry::pruneDestroyed()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->material) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+        }
+    }
+
+    // The reverse lookup still holds the addresses of the destroyed nodes
+    for (auto it = m_keys.begin(); it != m_keys.end();) {
+        auto entry = m_entries.constFind(it.value());
+        if (entry != m_entries.constEnd() && entry->material == it.key()) {
+            ++it;
+        } else {
+            it = m_keys.erase(it);
+        }
+    }
+}
+
+void Geo3DMaterialRegistry::clear()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        // Nodes parented to a destroyed scene are already gone
+        delete it->material.data();
+    }
+    m_entries.clear();
+    m_keys.clear();
+}
@@ -0,0 +1,269 @@
+/**
+ * @file geo3dmaterialregistry.h
+ * @brief Header file for the Geo3DMaterialRegistry class
+ */
+
+#ifndef GEO3DMATERIALREGISTRY_H
+#define GEO3DMATERIALREGISTRY_H
+
+#include <QColor>
+#include <QHash>
+#include <QPointer>
+
+QT_BEGIN_NAMESPACE
+namespace Qt3DCore {
+class QNode;
+}
+namespace Qt3DRender {
+class QMaterial;
+}
+QT_END_NAMESPACE
+
+/**
+ * @struct Geo3DMaterialKey
+ * @brief Value identity of a material as seen by the renderer
+ *
+ * Two objects with equal keys render identically and can share one
+ * Qt3D material node. The render state (blending and face culling) is part
+ * of the key because it selects the material type and its render passes.
+ */
+struct Geo3DMaterialKey
+{
+    QRgb diffuse;
+    QRgb ambient;
+    QRgb specular;
+    float shininess;
+    float opacity;
+    bool translucent;
+    bool cullBackFaces;
+
+    bool operator==(const Geo3DMaterialKey& other) const
+    {
+        return diffuse == other.diffuse
+            && ambient == other.ambient
+            && specular == other.specular
+            && shininess == other.shininess
+            && opacity == other.opacity
+            && translucent == other.translucent
+            && cullBackFaces == other.cullBackFaces;
+    }
+
+    bool operator!=(const Geo3DMaterialKey& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+size_t qHash(const Geo3DMaterialKey& key, size_t seed = 0);
+
+/**
+ * @class Geo3DMaterialRegistry
+ * @brief Interns Qt3D materials so objects with equal material properties share one node
+ *
+ * A scene typically uses a handful of soil classes across thousands of objects.
+ * Instead of allocating one material node per object, objects acquire a shared,
+ * reference-counted material for their property combination. An object whose
+ * properties change releases its material and acquires the one for the new
+ * combination (copy-on-write), so a shared node is never modified in place.
+ *
+ * Example usage:
+ * @code
+ * Geo3DMaterialKey key = Geo3DMaterialRegistry::makeKey(diffuse, ambient, specular, 50.0f, 1.0f, false, true);
+ * Qt3DRender::QMaterial* material = registry.acquire(key);
+ * entity->addComponent(material);
+ * ...
+ * entity->removeComponent(material);
+ * registry.release(material);
+ * @endcode
+ */
+class Geo3DMaterialRegistry
+{
+public:
+    /**
+     * @brief Default constructor
+     *
+     * Creates an empty registry without a parent node.
+     */
+    explicit Geo3DMaterialRegistry();
+
+    /**
+     * @brief Destructor
+     *
+     * Deletes all material nodes that are still alive.
+     */
+    ~Geo3DMaterialRegistry();
+
+    Geo3DMaterialRegistry(const Geo3DMaterialRegistry&) = delete;
+    Geo3DMaterialRegistry& operator=(const Geo3DMaterialRegistry&) = delete;
+
+    /**
+     * @brief Builds the key for a material property combination
+     *
+     * @param diffuse Diffuse color
+     * @param ambient Ambient color
+     * @param specular Specular color
+     * @param shininess Specular shininess
+     * @param opacity Opacity in the range [0, 1]
+     * @param translucent true for the blended path, false for the opaque path
+     * @param cullBackFaces true to discard back-facing triangles
+     * @return Key identifying the combination
+     */
+    static Geo3DMaterialKey makeKey(const QColor& diffuse, const QColor& ambient,
+                                    const QColor& specular, float shininess, float opacity,
+                                    bool translucent, bool cullBackFaces);
+
+    /**
+     * @brief Creates an unshared material node for a key
+     *
+     * Opaque keys produce a QPhongMaterial that writes depth; translucent keys
+     * produce a QPhongAlphaMaterial that blends and leaves the depth buffer
+     * untouched. Back-face culling is added to every render pass when requested.
+     *
+     * @param key Material property combination
+     * @param parent Owner of the new node (may be null)
+     * @return New material node
+     */
+    static Qt3DRender::QMaterial* createMaterial(const Geo3DMaterialKey& key, Qt3DCore::QNode* parent = nullptr);
+
+    /**
+     * @brief Updates the colors and shininess of a material created by createMaterial()
+     *
+     * The render state of the material is not changed; a key with a different
+     * translucent or cullBackFaces value requires a new material.
+     *
+     * @param material Material to update
+     * @param key New property combination
+     */
+    static void applyProperties(Qt3DRender::QMaterial* material, const Geo3DMaterialKey& key);
+
+    /**
+     * @brief Returns the shared material for a key, creating it on first use
+     *
+     * Each call adds a reference that must be returned with release().
+     *
+     * @param key Material property combination
+     * @return Shared material node
+     */
+    Qt3DRender::QMaterial* acquire(const Geo3DMaterialKey& key);
+
+    /**
+     * @brief Drops one reference to a shared material
+     *
+     * The material node is deleted when its last reference is released,
+     * unless unused materials are kept (see setKeepUnused()).
+     *
+     * @param material Material previously returned by acquire()
+     */
+    void release(Qt3DRender::QMaterial* material);
+
+    /**
+     * @brief Checks if a material node is managed by this registry
+     *
+     * @param material Material to look up
+     * @return true if the material was created by acquire() and is still referenced
+     */
+    bool contains(Qt3DRender::QMaterial* material) const;
+
+    /**
+     * @brief Gets the key a shared material was created for
+     *
+     * @param material Material previously returned by acquire()
+     * @param key Receives the key if the material is known
+     * @return true if the material is managed by this registry
+     */
+    bool keyOf(Qt3DRender::QMaterial* material, Geo3DMaterialKey& key) const;
+
+    /**
+     * @brief Gets the number of distinct material nodes currently alive
+     *
+     * @return Number of interned materials
+     */
+    int materialCount() const;
+
+    /**
+     * @brief Gets the number of objects sharing a material
+     *
+     * @param material Material to look up
+     * @return Reference count, or 0 if the material is unknown
+     */
+    int referenceCount(Qt3DRender::QMaterial* material) const;
+
+    /**
+     * @brief Keeps material nodes alive after their last reference is released
+     *
+     * Objects that are removed and added again, e.g. while paging through a
+     * site, then find their material still interned instead of building it
+     * again. Turning this off deletes the unused ones.
+     *
+     * @param keep true to keep unused material nodes until purgeUnused() or clear()
+     */
+    void setKeepUnused(bool keep);
+    bool getKeepUnused() const;
+
+    /**
+     * @brief Deletes the material nodes that no object references
+     */
+    void purgeUnused();
+
+    /**
+     * @brief Forgets the material nodes that were destroyed with their scene
+     *
+     * Objects whose entity died with the scene cannot release their
+     * references, so those entries are dropped here regardless of their
+     * reference count. Live entries are kept.
+     */
+    void pruneDestroyed();
+
+    /**
+     * @brief Sets the node that owns newly created material nodes
+     *
+     * Shared materials must not be owned by any single entity, otherwise
+     * deleting that entity would destroy a material other entities still use.
+     *
+     * @param parent Scene node under which materials are created
+     */
+    void setParentNode(Qt3DCore::QNode* parent);
+
+    /**
+     * @brief Gets the node that owns newly created material nodes
+     *
+     * @return Parent node, or nullptr if none is set or it was destroyed
+     */
+    Qt3DCore::QNode* getParentNode() const;
+
+    /**
+     * @brief Deletes all material nodes and forgets all references
+     */
+    void clear();
+
+private:
+    struct Entry
+    {
+        QPointer<Qt3DRender::QMaterial> material;
+        // Key in m_keys, still known after the node was destroyed
+        Qt3DRender::QMaterial* address;
+        int refCount;
+    };
+
+    /**
+     * @brief Interned materials keyed by their property combination
+     */
+    QHash<Geo3DMaterialKey, Entry> m_entries;
+
+    /**
+     * @brief Reverse lookup from material node to its key
+     */
+    QHash<Qt3DRender::QMaterial*, Geo3DMaterialKey> m_keys;
+
+    /**
+     * @brief Owner of newly created material nodes
+     */
+    QPointer<Qt3DCore::QNode> m_parentNode;
+
+    /**
+     * @brief Whether material nodes outlive their last reference
+     */
+    bool m_keepUnused;
+};
+
+#endif // GEO3DMATERIALREGISTRY_H
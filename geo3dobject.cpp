@@ -1,34 +1,100 @@
 #include "geo3dobject.h"
+#include "geo3dobjectset.h"
+#include "geo3dmaterialregistry.h"
+#include "geo3dgeometryregistry.h"
+#include "geo3dtessellationcache.h"
+#include "geo3dentitypool.h"
+#include "geo3dtrace.h"
 
 #include <Qt3DCore/QEntity>
 #include <Qt3DCore/QTransform>
+#include <Qt3DCore/QGeometry>
+#include <Qt3DCore/QBuffer>
+#include <Qt3DCore/QAttribute>
 #include <Qt3DRender/QGeometryRenderer>
-#include <Qt3DExtras/QPhongMaterial>
-#include <Qt3DExtras/QPhongAlphaMaterial>
+#include <Qt3DRender/QMaterial>
+#include <QReadWriteLock>
+#include <QHash>
 
+// Bytes of one element of an attribute
+static qint64 attributeElementSize(const Qt3DCore::QAttribute* attribute)
+{
+    switch (attribute->vertexBaseType()) {
+    case Qt3DCore::QAttribute::Byte:
+    case Qt3DCore::QAttribute::UnsignedByte:
+        return attribute->vertexSize();
+    case Qt3DCore::QAttribute::Short:
+    case Qt3DCore::QAttribute::UnsignedShort:
+    case Qt3DCore::QAttribute::HalfFloat:
+        return 2 * attribute->vertexSize();
+    case Qt3DCore::QAttribute::Double:
+        return 8 * attribute->vertexSize();
+    default:
+        return 4 * attribute->vertexSize();
+    }
+}
 
 Geo3DObject::Geo3DObject()
     : m_position(0.0f, 0.0f, 0.0f)
     , m_rotation(0.0f, 0.0f, 0.0f)
     , m_scale(1.0f, 1.0f, 1.0f)
+    , m_worldMatrixDirty(true)
     , m_diffuseColor(QColor(102, 84, 35))  // Brown color
     , m_ambientColor(QColor(68, 51, 17))   // Darker brown
     , m_specularColor(QColor(255, 255, 255)) // White
     , m_shininess(50.0f)
     , m_opacity(1.0f)
+    , m_blendMode(AutomaticBlend)
+    , m_cullMode(AutomaticCull)
     , m_visible(true)
     , m_entity(nullptr)
     , m_transform(nullptr)
     , m_material(nullptr)
+    , m_materialKey()
+    , m_sharedMaterial(false)
     , m_geometryRenderer(nullptr)
+    , m_sharedGeometry(false)
+    , m_proxyGeometry(false)
+    , m_entityPool(nullptr)
+    , m_objectSet(nullptr)
+    , m_pendingUpdates(0)
 {
 
 }
 
+Geo3DObject::Geo3DObject(const Geo3DObject& other)
+    : m_position(other.m_position)
+    , m_rotation(other.m_rotation)
+    , m_scale(other.m_scale)
+    , m_worldMatrixDirty(true)
+    , m_diffuseColor(other.m_diffuseColor)
+    , m_ambientColor(other.m_ambientColor)
+    , m_specularColor(other.m_specularColor)
+    , m_shininess(other.m_shininess)
+    , m_opacity(other.m_opacity)
+    , m_blendMode(other.m_blendMode)
+    , m_cullMode(other.m_cullMode)
+    , m_visible(other.m_visible)
+    , m_entity(nullptr)
+    , m_transform(nullptr)
+    , m_material(nullptr)
+    , m_materialKey()
+    , m_sharedMaterial(false)
+    , m_geometryRenderer(nullptr)
+    , m_sharedGeometry(false)
+    , m_proxyGeometry(false)
+    , m_entityPool(nullptr)
+    , m_objectSet(nullptr)
+    , m_pendingUpdates(0)
+{
+    // Qt3D components and the owning set stay with the original
+}
+
 Geo3DObject::~Geo3DObject()
 {
-    // Qt3D entities are automatically cleaned up by parent-child relationships
-    // No explicit cleanup needed here
+    // Take the entity out of a live scene; shared materials and geometry
+    // go back to the set's registries
+    releaseEntity();
 }
 
 QVector3D Geo3DObject::getPosition() const
@@ -39,7 +105,8 @@ QVector3D Geo3DObject::getPosition() const
 void Geo3DObject::setPosition(const QVector3D& position)
 {
     m_position = position;
-    updateTransform();
+    m_worldMatrixDirty = true;
+    requestUpdate(TransformUpdate);
 }
 
 void Geo3DObject::setPosition(float x, float y, float z)
@@ -55,7 +122,8 @@ QVector3D Geo3DObject::getRotation() const
 void Geo3DObject::setRotation(const QVector3D& rotation)
 {
     m_rotation = rotation;
-    updateTransform();
+    m_worldMatrixDirty = true;
+    requestUpdate(TransformUpdate);
 }
 
 void Geo3DObject::setRotation(float x, float y, float z)
@@ -71,7 +139,8 @@ QVector3D Geo3DObject::getScale() const
 void Geo3DObject::setScale(const QVector3D& scale)
 {
     m_scale = scale;
-    updateTransform();
+    m_worldMatrixDirty = true;
+    requestUpdate(TransformUpdate);
 }
 
 void Geo3DObject::setScale(float uniformScale)
@@ -84,6 +153,60 @@ void Geo3DObject::setScale(float x, float y, float z)
     setScale(QVector3D(x, y, z));
 }
 
+QQuaternion Geo3DObject::getRotationQuaternion() const
+{
+    return QQuaternion::fromEulerAngles(m_rotation);
+}
+
+QMatrix4x4 Geo3DObject::getWorldMatrix() const
+{
+    if (m_worldMatrixDirty) {
+        m_worldMatrix.setToIdentity();
+        m_worldMatrix.translate(m_position);
+        m_worldMatrix.rotate(getRotationQuaternion());
+        m_worldMatrix.scale(m_scale);
+        m_worldMatrixDirty = false;
+    }
+    return m_worldMatrix;
+}
+
+QByteArray Geo3DObject::getShapeKey() const
+{
+    return QByteArray();
+}
+
+bool Geo3DObject::getLocalBounds(QVector3D& minimum, QVector3D& maximum) const
+{
+    Q_UNUSED(minimum);
+    Q_UNUSED(maximum);
+    return false;
+}
+
+bool Geo3DObject::getBoundingBox(QVector3D& minimum, QVector3D& maximum) const
+{
+    QVector3D localMin;
+    QVector3D localMax;
+    if (!getLocalBounds(localMin, localMax)) {
+        return false;
+    }
+
+    const QMatrix4x4 matrix = getWorldMatrix();
+    for (int corner = 0; corner < 8; ++corner) {
+        QVector3D point((corner & 1) ? localMax.x() : localMin.x(),
+                        (corner & 2) ? localMax.y() : localMin.y(),
+                        (corner & 4) ? localMax.z() : localMin.z());
+        point = matrix.map(point);
+
+        if (corner == 0) {
+            minimum = maximum = point;
+        } else {
+            minimum = QVector3D(qMin(minimum.x(), point.x()), qMin(minimum.y(), point.y()), qMin(minimum.z(), point.z()));
+            maximum = QVector3D(qMax(maximum.x(), point.x()), qMax(maximum.y(), point.y()), qMax(maximum.z(), point.z()));
+        }
+    }
+    return true;
+}
+
 QColor Geo3DObject::getDiffuseColor() const
 {
     return m_diffuseColor;
@@ -92,7 +215,7 @@ QColor Geo3DObject::getDiffuseColor() const
 void Geo3DObject::setDiffuseColor(const QColor& color)
 {
     m_diffuseColor = color;
-    updateMaterial();
+    requestUpdate(MaterialUpdate);
 }
 
 QColor Geo3DObject::getAmbientColor() const
@@ -103,7 +226,7 @@ QColor Geo3DObject::getAmbientColor() const
 void Geo3DObject::setAmbientColor(const QColor& color)
 {
     m_ambientColor = color;
-    updateMaterial();
+    requestUpdate(MaterialUpdate);
 }
 
 QColor Geo3DObject::getSpecularColor() const
@@ -114,7 +237,7 @@ QColor Geo3DObject::getSpecularColor() const
 void Geo3DObject::setSpecularColor(const QColor& color)
 {
     m_specularColor = color;
-    updateMaterial();
+    requestUpdate(MaterialUpdate);
 }
 
 float Geo3DObject::getShininess() const
@@ -125,7 +248,7 @@ float Geo3DObject::getShininess() const
 void Geo3DObject::setShininess(float shininess)
 {
     m_shininess = shininess;
-    updateMaterial();
+    requestUpdate(MaterialUpdate);
 }
 
 float Geo3DObject::getOpacity() const
@@ -136,7 +259,103 @@ float Geo3DObject::getOpacity() const
 void Geo3DObject::setOpacity(float opacity)
 {
     m_opacity = qBound(0.0f, opacity, 1.0f);
-    updateMaterial();
+    requestUpdate(MaterialUpdate);
+}
+
+Geo3DObject::BlendMode Geo3DObject::getBlendMode() const
+{
+    return m_blendMode;
+}
+
+void Geo3DObject::setBlendMode(BlendMode mode)
+{
+    m_blendMode = mode;
+    requestUpdate(MaterialUpdate);
+}
+
+Geo3DObject::CullMode Geo3DObject::getCullMode() const
+{
+    return m_cullMode;
+}
+
+void Geo3DObject::setCullMode(CullMode mode)
+{
+    m_cullMode = mode;
+    requestUpdate(MaterialUpdate);
+}
+
+void Geo3DObject::renderModesToJson(QJsonObject& json) const
+{
+    if (m_blendMode == OpaqueBlend) {
+        json["blendMode"] = QStringLiteral("opaque");
+    } else if (m_blendMode == TranslucentBlend) {
+        json["blendMode"] = QStringLiteral("translucent");
+    }
+
+    if (m_cullMode == BackFaceCull) {
+        json["cullMode"] = QStringLiteral("back");
+    } else if (m_cullMode == NoCull) {
+        json["cullMode"] = QStringLiteral("none");
+    }
+}
+
+void Geo3DObject::renderModesFromJson(const QJsonObject& json)
+{
+    const QString blendMode = json["blendMode"].toString();
+    BlendMode blend = AutomaticBlend;
+    if (blendMode == QLatin1String("opaque")) {
+        blend = OpaqueBlend;
+    } else if (blendMode == QLatin1String("translucent")) {
+        blend = TranslucentBlend;
+    }
+
+    const QString cullMode = json["cullMode"].toString();
+    CullMode cull = AutomaticCull;
+    if (cullMode == QLatin1String("back")) {
+        cull = BackFaceCull;
+    } else if (cullMode == QLatin1String("none")) {
+        cull = NoCull;
+    }
+
+    // Only changed modes mark the object as modified
+    if (blend != m_blendMode) {
+        setBlendMode(blend);
+    }
+    if (cull != m_cullMode) {
+        setCullMode(cull);
+    }
+}
+
+bool Geo3DObject::isTranslucent() const
+{
+    switch (m_blendMode) {
+    case OpaqueBlend:
+        return false;
+    case TranslucentBlend:
+        return true;
+    case AutomaticBlend:
+    default:
+        return m_opacity < 1.0f;
+    }
+}
+
+bool Geo3DObject::isBackFaceCulled() const
+{
+    switch (m_cullMode) {
+    case BackFaceCull:
+        return true;
+    case NoCull:
+        return false;
+    case AutomaticCull:
+    default:
+        // Back faces show through translucent surfaces
+        return !isTranslucent() && isClosedSurface();
+    }
+}
+
+bool Geo3DObject::isClosedSurface() const
+{
+    return false;
 }
 
 bool Geo3DObject::isVisible() const
@@ -147,90 +366,631 @@ bool Geo3DObject::isVisible() const
 void Geo3DObject::setVisible(bool visible)
 {
     m_visible = visible;
-    if (m_entity) {
-        m_entity->setEnabled(visible);
+    requestUpdate(VisibilityUpdate);
+}
+
+bool Geo3DObject::hasPendingUpdates() const
+{
+    return m_pendingUpdates != 0;
+}
+
+void Geo3DObject::applyPendingUpdates()
+{
+    int flags = m_pendingUpdates;
+    m_pendingUpdates = 0;
+
+    // Without an entity there is nothing to push; createEntity() applies
+    // the current state when the entity is eventually built
+    if (!m_entity) {
+        return;
+    }
+
+    if (flags & GeometryUpdate) {
+        updateGeometry();
+    }
+    if (flags & TransformUpdate) {
+        updateTransform();
+    }
+    if (flags & MaterialUpdate) {
+        updateMaterial();
     }
+    if (flags & VisibilityUpdate) {
+        m_entity->setEnabled(m_visible);
+    }
+}
+
+void Geo3DObject::requestUpdate(int flags)
+{
+    // Every property change passes through here, so this is where the
+    // owning set learns which objects need to be saved again
+    if (m_objectSet) {
+        m_objectSet->noteObjectChanged(this);
+    }
+    scheduleUpdate(flags);
+}
+
+void Geo3DObject::scheduleUpdate(int flags)
+{
+    if (m_objectSet && m_objectSet->isEditing()) {
+        if (m_pendingUpdates == 0) {
+            m_objectSet->queueUpdate(this);
+        }
+        m_pendingUpdates |= flags;
+        return;
+    }
+
+    m_pendingUpdates |= flags;
+    applyPendingUpdates();
+}
+
+void Geo3DObject::invalidateGeometry()
+{
+    requestUpdate(GeometryUpdate);
 }
 
 Qt3DCore::QEntity* Geo3DObject::createEntity(Qt3DCore::QEntity* parent)
 {
+    forgetDestroyedEntity();
     if (!m_entity) {
-        m_entity = new Qt3DCore::QEntity(parent);
+        checkOutEntity(parent);
 
-        // Create geometry
-        m_geometryRenderer = createGeometry();
-        m_entity->addComponent(m_geometryRenderer);
+        // Create or acquire the geometry
+        acquireGeometry();
+        setUpEntity();
+    }
 
-        // Create transform
-        m_transform = new Qt3DCore::QTransform();
-        updateTransform();
-        m_entity->addComponent(m_transform);
+    return m_entity;
+}
 
-        // Create material
-        m_material = new Qt3DExtras::QPhongAlphaMaterial();
-        updateMaterial();
-        m_entity->addComponent(m_material);
+Qt3DCore::QEntity* Geo3DObject::createProxyEntity(Qt3DCore::QEntity* parent)
+{
+    forgetDestroyedEntity();
+    if (!m_entity) {
+        checkOutEntity(parent);
+        acquireProxyGeometry();
+        setUpEntity();
+    }
 
+    return m_entity;
+}
 
-        m_entity->setEnabled(m_visible);
+bool Geo3DObject::hasProxyGeometry() const
+{
+    return m_proxyGeometry;
+}
 
-        // Set visibility
-        m_entity->setEnabled(m_visible);
+void Geo3DObject::replaceProxyGeometry(const MeshData* mesh)
+{
+    if (!m_entity || !m_proxyGeometry) {
+        return;
+    }
+
+    releaseGeometry();
+    acquireGeometry(mesh);
+}
+
+void Geo3DObject::checkOutEntity(Qt3DCore::QEntity* parent)
+{
+    Geo3DEntityPool* pool = m_objectSet ? m_objectSet->getEntityPool() : nullptr;
+    if (pool) {
+        const Geo3DEntityPool::Bundle bundle = pool->acquire(parent);
+        m_entity = bundle.entity;
+        m_transform = bundle.transform;
+        m_entityPool = pool;
+    } else {
+        m_entity = new Qt3DCore::QEntity(parent);
+        m_entityPool = nullptr;
+    }
+}
+
+void Geo3DObject::setUpEntity()
+{
+    // Create transform, unless the entity came from the pool with one
+    if (!m_transform) {
+        m_transform = new Qt3DCore::QTransform();
+        m_entity->addComponent(m_transform);
     }
+    updateTransform();
+
+    // Create or acquire the material
+    updateMaterial();
 
+    // Set visibility
+    m_entity->setEnabled(m_visible);
+
+    // Everything above reflects the current state
+    m_pendingUpdates = 0;
+}
+
+Qt3DCore::QEntity* Geo3DObject::getEntity() const
+{
     return m_entity;
 }
 
 void Geo3DObject::updateTransform()
 {
-    if (m_transform) {
-        m_transform->setTranslation(m_position);
-        m_transform->setRotationX(m_rotation.x());
-        m_transform->setRotationY(m_rotation.y());
-        m_transform->setRotationZ(m_rotation.z());
-        m_transform->setScale3D(m_scale);
+    if (m_entity && m_transform) {
+        // One property change instead of separate translation/rotation/scale updates
+        m_transform->setMatrix(getWorldMatrix());
     }
 }
 
 void Geo3DObject::updateMaterial()
 {
-    if (m_material) {
-        QColor diffuse = m_diffuseColor;
-        diffuse.setAlphaF(m_opacity);
+    if (!m_entity) {
+        return;
+    }
+
+    Geo3DMaterialKey key = Geo3DMaterialRegistry::makeKey(m_diffuseColor, m_ambientColor,
+                                                          m_specularColor, m_shininess, m_opacity,
+                                                          isTranslucent(), isBackFaceCulled());
+
+    Geo3DMaterialRegistry* registry = m_objectSet ? m_objectSet->getMaterialRegistry() : nullptr;
+    if (registry) {
+        if (m_sharedMaterial && m_material && m_materialKey == key) {
+            return;
+        }
+
+        // Never modify a shared node in place: drop it and intern the new combination
+        if (!registry->getParentNode()) {
+            registry->setParentNode(m_entity->parentNode());
+        }
+        Qt3DRender::QMaterial* material = registry->acquire(key);
+        if (m_material) {
+            releaseMaterial();
+        }
+        m_material = material;
+        m_materialKey = key;
+        m_sharedMaterial = true;
+        m_entity->addComponent(m_material);
+        return;
+    }
+
+    if (m_sharedMaterial) {
+        releaseMaterial();
+    }
+
+    // A change of render state needs a different material type or render passes
+    if (m_material && (m_materialKey.translucent != key.translucent
+                       || m_materialKey.cullBackFaces != key.cullBackFaces)) {
+        releaseMaterial();
+    }
+
+    if (!m_material) {
+        m_material = Geo3DMaterialRegistry::createMaterial(key);
+        m_entity->addComponent(m_material);
+    } else {
+        Geo3DMaterialRegistry::applyProperties(m_material, key);
+    }
+    m_materialKey = key;
+}
+
+void Geo3DObject::releaseMaterial()
+{
+    if (!m_material) {
+        return;
+    }
+
+    if (m_entity) {
+        m_entity->removeComponent(m_material);
+    }
+
+    if (m_sharedMaterial) {
+        Geo3DMaterialRegistry* registry = m_objectSet ? m_objectSet->getMaterialRegistry() : nullptr;
+        if (registry) {
+            registry->release(m_material);
+        }
+    } else {
+        delete m_material;
+    }
+
+    m_material = nullptr;
+    m_sharedMaterial = false;
+}
+
+void Geo3DObject::updateGeometry()
+{
+    if (!m_entity) {
+        return;
+    }
+
+    releaseGeometry();
+    acquireGeometry();
+}
+
+void Geo3DObject::acquireGeometry(const MeshData* mesh)
+{
+    const QByteArray key = getShapeKey();
+    Geo3DGeometryRegistry* registry = m_objectSet ? m_objectSet->getGeometryRegistry() : nullptr;
+    auto build = [this, mesh]() { return mesh ? createGeometryFromMesh(*mesh) : buildGeometry(); };
+
+    if (registry && !key.isEmpty()) {
+        if (!registry->getParentNode()) {
+            registry->setParentNode(m_entity->parentNode());
+        }
+        m_geometryRenderer = registry->acquire(key, build);
+        m_sharedGeometry = (m_geometryRenderer != nullptr);
+    } else {
+        m_geometryRenderer = build();
+        m_sharedGeometry = false;
+    }
+    m_proxyGeometry = false;
+
+    if (m_geometryRenderer) {
+        m_entity->addComponent(m_geometryRenderer);
+    }
+}
+
+void Geo3DObject::acquireProxyGeometry()
+{
+    QVector3D minimum, maximum;
+    if (!getLocalBounds(minimum, maximum)) {
+        acquireGeometry();
+        return;
+    }
+
+    // Boxes of equal size share one renderer, like regular shapes
+    QByteArray key("BoundingBoxProxy");
+    key.append(reinterpret_cast<const char*>(&minimum), sizeof(minimum));
+    key.append(reinterpret_cast<const char*>(&maximum), sizeof(maximum));
+    auto build = [&minimum, &maximum]() { return createGeometryFromMesh(createBoxMesh(minimum, maximum)); };
+
+    Geo3DGeometryRegistry* registry = m_objectSet ? m_objectSet->getGeometryRegistry() : nullptr;
+    if (registry) {
+        if (!registry->getParentNode()) {
+            registry->setParentNode(m_entity->parentNode());
+        }
+        m_geometryRenderer = registry->acquire(key, build);
+        m_sharedGeometry = (m_geometryRenderer != nullptr);
+    } else {
+        m_geometryRenderer = build();
+        m_sharedGeometry = false;
+    }
+    m_proxyGeometry = true;
+
+    if (m_geometryRenderer) {
+        m_entity->addComponent(m_geometryRenderer);
+    }
+}
+
+Qt3DRender::QGeometryRenderer* Geo3DObject::buildGeometry()
+{
+    MeshData mesh;
+    if (tessellate(mesh)) {
+        return createGeometryFromMesh(mesh);
+    }
+    return createGeometry();
+}
+
+bool Geo3DObject::tessellate(MeshData& mesh) const
+{
+    // Procedural Qt3D meshes have nothing to cache
+    if (!hasGeneratedMesh()) {
+        return false;
+    }
 
-        QColor ambient = m_ambientColor;
-        ambient.setAlphaF(m_opacity);
+    Geo3DTessellationCache* cache = m_objectSet ? m_objectSet->getTessellationCache() : nullptr;
+    const QByteArray key = cache ? getShapeKey() : QByteArray();
 
-        m_material->setDiffuse(diffuse);
-        m_material->setAmbient(ambient);
-        m_material->setSpecular(m_specularColor);
-        m_material->setShininess(m_shininess);
+    if (!key.isEmpty()) {
+        GEO3D_TRACE_SCOPE("tessellation", "tessellationCacheLookup");
+        if (cache->lookup(key, mesh)) {
+            return true;
+        }
+    }
+    {
+        GEO3D_TRACE_SCOPE("tessellation", "generateMesh");
+        if (!generateMesh(mesh)) {
+            return false;
+        }
     }
+    if (!key.isEmpty()) {
+        GEO3D_TRACE_SCOPE("tessellation", "tessellationCacheStore");
+        cache->store(key, mesh);
+    }
+    return true;
+}
+
+Geo3DObject::MeshData Geo3DObject::createBoxMesh(const QVector3D& minimum, const QVector3D& maximum)
+{
+    // Six faces with their own vertices, so every face is lit flat
+    static const int s_faceCorners[6][4] = {
+        {0, 2, 6, 4},  // -X
+        {1, 5, 7, 3},  // +X
+        {0, 4, 5, 1},  // -Y
+        {2, 3, 7, 6},  // +Y
+        {0, 1, 3, 2},  // -Z
+        {4, 6, 7, 5}   // +Z
+    };
+    static const float s_faceNormals[6][3] = {
+        {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+    };
+
+    MeshData mesh;
+    mesh.hasNormals = true;
+    mesh.vertexCount = 24;
+    mesh.indexCount = 36;
+    mesh.vertices.resize(mesh.vertexCount * mesh.componentsPerVertex() * int(sizeof(float)));
+    mesh.indices.resize(mesh.indexCount * int(sizeof(unsigned int)));
+
+    float* vertex = reinterpret_cast<float*>(mesh.vertices.data());
+    unsigned int* index = reinterpret_cast<unsigned int*>(mesh.indices.data());
+    for (int face = 0; face < 6; ++face) {
+        for (int corner = 0; corner < 4; ++corner) {
+            // Bit 0 selects x, bit 1 y and bit 2 z of the maximum corner
+            const int bits = s_faceCorners[face][corner];
+            *vertex++ = (bits & 1) ? maximum.x() : minimum.x();
+            *vertex++ = (bits & 2) ? maximum.y() : minimum.y();
+            *vertex++ = (bits & 4) ? maximum.z() : minimum.z();
+            *vertex++ = s_faceNormals[face][0];
+            *vertex++ = s_faceNormals[face][1];
+            *vertex++ = s_faceNormals[face][2];
+        }
+
+        const unsigned int base = unsigned(face * 4);
+        *index++ = base;
+        *index++ = base + 1;
+        *index++ = base + 2;
+        *index++ = base;
+        *index++ = base + 2;
+        *index++ = base + 3;
+    }
+    return mesh;
+}
+
+int Geo3DObject::getTriangleCount() const
+{
+    return 0;
+}
+
+Geo3DObject::MemoryUsage Geo3DObject::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.parameterBytes = sizeof(Geo3DObject);
+    return usage;
 }
 
-// Static registry for object factories
-static QMap<QString, Geo3DObject::ObjectFactory> s_objectFactories;
+qint64 Geo3DObject::geometryByteSize(const Qt3DRender::QGeometryRenderer* renderer)
+{
+    const Qt3DCore::QGeometry* geometry = renderer->geometry();
+    if (!geometry) {
+        return 0;
+    }
+
+    QHash<const Qt3DCore::QBuffer*, qint64> bufferSizes;
+    const QList<Qt3DCore::QAttribute*> attributes = geometry->attributes();
+    for (const Qt3DCore::QAttribute* attribute : attributes) {
+        const Qt3DCore::QBuffer* buffer = attribute->buffer();
+        if (!buffer) {
+            continue;
+        }
+
+        // Generated buffers may not be filled on the frontend yet; fall back to the extent of the attribute
+        qint64 size = buffer->data().size();
+        if (size == 0 && attribute->count() > 0) {
+            const qint64 elementSize = attributeElementSize(attribute);
+            const qint64 stride = attribute->byteStride() ? attribute->byteStride() : elementSize;
+            size = attribute->byteOffset() + (attribute->count() - 1) * stride + elementSize;
+        }
+        bufferSizes[buffer] = qMax(bufferSizes.value(buffer), size);
+    }
+
+    qint64 total = 0;
+    for (qint64 size : std::as_const(bufferSizes)) {
+        total += size;
+    }
+    return total;
+}
+
+bool Geo3DObject::generateMesh(MeshData& mesh) const
+{
+    Q_UNUSED(mesh);
+    return false;
+}
+
+bool Geo3DObject::hasGeneratedMesh() const
+{
+    return false;
+}
+
+Qt3DRender::QGeometryRenderer* Geo3DObject::createGeometryFromMesh(const MeshData& mesh)
+{
+    Qt3DCore::QGeometry* geometry = new Qt3DCore::QGeometry();
+    const uint stride = uint(mesh.componentsPerVertex() * sizeof(float));
+
+    Qt3DCore::QBuffer* vertexBuffer = new Qt3DCore::QBuffer(geometry);
+    vertexBuffer->setData(mesh.vertices);
+
+    Qt3DCore::QBuffer* indexBuffer = new Qt3DCore::QBuffer(geometry);
+    indexBuffer->setData(mesh.indices);
+
+    // Position attribute
+    Qt3DCore::QAttribute* positionAttribute = new Qt3DCore::QAttribute(geometry);
+    positionAttribute->setName(Qt3DCore::QAttribute::defaultPositionAttributeName());
+    positionAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
+    positionAttribute->setVertexSize(3);
+    positionAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+    positionAttribute->setBuffer(vertexBuffer);
+    positionAttribute->setByteStride(stride);
+    positionAttribute->setCount(mesh.vertexCount);
+    geometry->addAttribute(positionAttribute);
+
+    // Normal attribute
+    if (mesh.hasNormals) {
+        Qt3DCore::QAttribute* normalAttribute = new Qt3DCore::QAttribute(geometry);
+        normalAttribute->setName(Qt3DCore::QAttribute::defaultNormalAttributeName());
+        normalAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
+        normalAttribute->setVertexSize(3);
+        normalAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
+        normalAttribute->setBuffer(vertexBuffer);
+        normalAttribute->setByteStride(stride);
+        normalAttribute->setByteOffset(3 * sizeof(float));
+        normalAttribute->setCount(mesh.vertexCount);
+        geometry->addAttribute(normalAttribute);
+    }
+
+    // Index attribute
+    Qt3DCore::QAttribute* indexAttribute = new Qt3DCore::QAttribute(geometry);
+    indexAttribute->setAttributeType(Qt3DCore::QAttribute::IndexAttribute);
+    indexAttribute->setVertexBaseType(Qt3DCore::QAttribute::UnsignedInt);
+    indexAttribute->setBuffer(indexBuffer);
+    indexAttribute->setCount(mesh.indexCount);
+    geometry->addAttribute(indexAttribute);
+
+    Qt3DRender::QGeometryRenderer* renderer = new Qt3DRender::QGeometryRenderer();
+    renderer->setGeometry(geometry);
+    renderer->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
+
+    return renderer;
+}
+
+void Geo3DObject::releaseEntity()
+{
+    forgetDestroyedEntity();
+    if (!m_entity) {
+        return;
+    }
+
+    releaseMaterial();
+    releaseGeometry();
+
+    // The transform is a child of the entity and goes with it
+    if (m_entityPool) {
+        Geo3DEntityPool::Bundle bundle;
+        bundle.entity = m_entity;
+        bundle.transform = m_transform;
+        m_entityPool->release(bundle);
+    } else {
+        delete m_entity.data();
+    }
+    m_entity = nullptr;
+    m_transform = nullptr;
+    m_entityPool = nullptr;
+    m_pendingUpdates = 0;
+}
+
+void Geo3DObject::forgetDestroyedEntity()
+{
+    // A set-up entity always has a transform; without the entity it died with its scene
+    if (m_entity || !m_transform) {
+        return;
+    }
+
+    // Owned components were children of the entity and shared nodes lived under
+    // the same scene. The registries replace destroyed entries on the next acquire;
+    // releasing here could hit a new node that reuses a destroyed node's address.
+    m_transform = nullptr;
+    m_material = nullptr;
+    m_sharedMaterial = false;
+    m_geometryRenderer = nullptr;
+    m_sharedGeometry = false;
+    m_proxyGeometry = false;
+    m_entityPool = nullptr;
+    m_pendingUpdates = 0;
+}
+
+void Geo3DObject::releaseGeometry()
+{
+    if (!m_geometryRenderer) {
+        return;
+    }
+
+    if (m_entity) {
+        m_entity->removeComponent(m_geometryRenderer);
+    }
+
+    if (m_sharedGeometry) {
+        Geo3DGeometryRegistry* registry = m_objectSet ? m_objectSet->getGeometryRegistry() : nullptr;
+        if (registry) {
+            registry->release(m_geometryRenderer);
+        }
+    } else {
+        delete m_geometryRenderer;
+    }
+
+    m_geometryRenderer = nullptr;
+    m_sharedGeometry = false;
+    m_proxyGeometry = false;
+}
+
+// Factory registry shared by all threads that deserialize objects. Function-local
+// statics avoid depending on the initialization order of the registering units.
+static QMap<QString, Geo3DObject::ObjectFactory>& objectFactories()
+{
+    static QMap<QString, Geo3DObject::ObjectFactory> factories;
+    return factories;
+}
+
+static QReadWriteLock& objectFactoriesLock()
+{
+    static QReadWriteLock lock;
+    return lock;
+}
+
+static Geo3DObject::ObjectFactory findObjectFactory(const QString& typeName)
+{
+    QReadLocker locker(&objectFactoriesLock());
+    return objectFactories().value(typeName);
+}
 
 void Geo3DObject::registerObjectType(const QString& typeName, ObjectFactory factory)
 {
-    s_objectFactories[typeName] = factory;
+    QWriteLocker locker(&objectFactoriesLock());
+    objectFactories()[typeName] = factory;
+}
+
+QCborMap Geo3DObject::toCbor() const
+{
+    return QCborMap::fromJsonObject(toJson());
+}
+
+bool Geo3DObject::fromCbor(const QCborMap& cbor)
+{
+    return fromJson(cbor.toJsonObject());
+}
+
+Geo3DObject* Geo3DObject::createFromCbor(const QCborMap& cbor)
+{
+    QString objectType = cbor.value(QStringLiteral("type")).toString();
+    if (objectType.isEmpty()) {
+        return nullptr;
+    }
+
+    ObjectFactory factory = findObjectFactory(objectType);
+    if (!factory) {
+        return nullptr; // Unknown object type
+    }
+
+    Geo3DObject* object = factory();
+    if (object && object->fromCbor(cbor)) {
+        return object;
+    } else {
+        delete object;
+        return nullptr;
+    }
 }
 
 Geo3DObject* Geo3DObject::createFromJson(const QJsonObject& json)
 {
+    GEO3D_TRACE_SCOPE("load", "createFromJson");
     if (!json.contains("type")) {
         return nullptr;
     }
 
     QString objectType = json["type"].toString();
 
-    auto it = s_objectFactories.find(objectType);
-    if (it == s_objectFactories.end()) {
+    ObjectFactory factory = findObjectFactory(objectType);
+    if (!factory) {
         return nullptr; // Unknown object type
     }
 
-    Geo3DObject* object = it.value()(); // Call factory function
-    if (object && object->fromJson(json)) {
+    Geo3DObject* object = factory(); // Call factory function
+    bool loaded = false;
+    if (object) {
+        GEO3D_TRACE_SCOPE("load", "Geo3DObject::fromJson");
+        loaded = object->fromJson(json);
+    }
+    if (loaded) {
         return object;
     } else {
         delete object;
@@ -2,10 +2,17 @@
 #define GEO3DOBJECT_H
 
 #include <QVector3D>
+#include <QQuaternion>
+#include <QMatrix4x4>
 #include <QColor>
+#include <QByteArray>
 #include <QJsonObject>
+#include <QCborMap>
 #include <functional>
 #include <QMap>
+#include <QPointer>
+
+#include "geo3dmaterialregistry.h"
 
 QT_BEGIN_NAMESPACE
 namespace Qt3DCore {
@@ -14,20 +21,51 @@ class QTransform;
 }
 namespace Qt3DRender {
 class QGeometryRenderer;
-
-}
-namespace Qt3DExtras {
-class QPhongMaterial;
-class QPhongAlphaMaterial;
+class QMaterial;
 }
 QT_END_NAMESPACE
 
+class Geo3DObjectSet;
+class Geo3DEntityPool;
+
 class Geo3DObject
 {
 public:
     explicit Geo3DObject();
     virtual ~Geo3DObject();
 
+    Geo3DObject& operator=(const Geo3DObject&) = delete;
+
+    /**
+     * @brief Triangle mesh in the layout uploaded to Qt3D
+     *
+     * Vertices are interleaved float32 values: a position, optionally
+     * followed by a normal. Indices are 32-bit unsigned triangle lists.
+     */
+    struct MeshData
+    {
+        QByteArray vertices;
+        QByteArray indices;
+        int vertexCount = 0;
+        int indexCount = 0;
+        bool hasNormals = false;
+
+        // Number of floats per vertex
+        int componentsPerVertex() const { return hasNormals ? 6 : 3; }
+    };
+
+    /**
+     * @brief CPU-side memory held by the object itself
+     *
+     * Qt3D nodes and mesh buffers are shared between objects and are
+     * accounted by Geo3DObjectSet::memoryReport().
+     */
+    struct MemoryUsage
+    {
+        qint64 parameterBytes = 0;    ///< The object and its fixed-size shape parameters
+        qint64 vertexArrayBytes = 0;  ///< Heap arrays of user-supplied vertices
+    };
+
     // Transform properties
     QVector3D getPosition() const;
     void setPosition(const QVector3D& position);
@@ -42,6 +80,43 @@ public:
     void setScale(float uniformScale);
     void setScale(float x, float y, float z);
 
+    /**
+     * @brief Gets the rotation as a quaternion
+     *
+     * The Euler angles from getRotation() are interpreted in degrees, in the
+     * same order Qt3DCore::QTransform uses for rotationX/Y/Z.
+     */
+    QQuaternion getRotationQuaternion() const;
+
+    /**
+     * @brief Gets the composed world matrix (translation * rotation * scale)
+     *
+     * The matrix is cached and only recomposed after the position, rotation
+     * or scale has changed.
+     */
+    QMatrix4x4 getWorldMatrix() const;
+
+    /**
+     * @brief Gets the axis-aligned bounds of the geometry in object space
+     *
+     * @param minimum Receives the minimum corner
+     * @param maximum Receives the maximum corner
+     * @return false if the object has no extent (the default)
+     */
+    virtual bool getLocalBounds(QVector3D& minimum, QVector3D& maximum) const;
+
+    /**
+     * @brief Gets the axis-aligned bounds of the object in world space
+     *
+     * The corners of getLocalBounds() are transformed by getWorldMatrix(),
+     * so the box encloses the rotated and scaled geometry.
+     *
+     * @param minimum Receives the minimum corner
+     * @param maximum Receives the maximum corner
+     * @return false if the object has no extent
+     */
+    bool getBoundingBox(QVector3D& minimum, QVector3D& maximum) const;
+
     // Material properties
     QColor getDiffuseColor() const;
     void setDiffuseColor(const QColor& color);
@@ -58,18 +133,227 @@ public:
     float getOpacity() const;
     void setOpacity(float opacity);
 
+    // Render state
+
+    // How the object is blended with what is behind it
+    enum BlendMode {
+        AutomaticBlend,   // Opaque when opacity is 1, translucent otherwise
+        OpaqueBlend,      // Always drawn without blending, writing depth
+        TranslucentBlend  // Always blended, without writing depth
+    };
+
+    // Which triangles are discarded by the rasterizer
+    enum CullMode {
+        AutomaticCull,    // Back faces culled for opaque closed surfaces only
+        BackFaceCull,     // Always cull back faces
+        NoCull            // Draw both sides
+    };
+
+    BlendMode getBlendMode() const;
+    void setBlendMode(BlendMode mode);
+
+    CullMode getCullMode() const;
+    void setCullMode(CullMode mode);
+
+    /**
+     * @brief Checks whether the object is drawn with the blended material path
+     *
+     * Resolves AutomaticBlend from the current opacity.
+     */
+    bool isTranslucent() const;
+
+    /**
+     * @brief Checks whether back faces of the object are culled
+     *
+     * Resolves AutomaticCull from isTranslucent() and isClosedSurface().
+     */
+    bool isBackFaceCulled() const;
+
+    /**
+     * @brief Tells whether the geometry encloses a volume
+     *
+     * Back faces of a closed opaque surface are never visible, so they can be
+     * culled. Open surfaces such as a single face must keep both sides.
+     *
+     * @return false by default; closed solids override this
+     */
+    virtual bool isClosedSurface() const;
+
+    /**
+     * @brief Identifies the geometry produced by createGeometry()
+     *
+     * Objects in the same Geo3DObjectSet whose keys are equal share one
+     * Qt3D geometry renderer. The key must cover every parameter that
+     * affects the mesh in object space; the transform is not part of it.
+     *
+     * @return Key for the current shape parameters, or an empty key if the
+     *         geometry must not be shared (the default)
+     */
+    virtual QByteArray getShapeKey() const;
+
+    /**
+     * @brief Tessellates the shape on the CPU
+     *
+     * Objects whose geometry is generated here can have their meshes stored
+     * in a Geo3DTessellationCache and reused on the next start. Objects that
+     * rely on a Qt3D procedural mesh keep the default.
+     *
+     * @param mesh Receives the vertex and index buffers
+     * @return true if a mesh was produced; false by default
+     */
+    virtual bool generateMesh(MeshData& mesh) const;
+
+    /**
+     * @brief Tells whether generateMesh() is implemented for the type
+     *
+     * Objects without a CPU-generated mesh skip the tessellation cache
+     * entirely, so they are neither looked up nor counted as misses.
+     *
+     * @return true if generateMesh() can produce a mesh; false by default
+     */
+    virtual bool hasGeneratedMesh() const;
+
+    /**
+     * @brief Produces the mesh, going through the set's tessellation cache
+     *
+     * Does not touch Qt3D, so it may run on a worker thread while the object
+     * is not modified.
+     *
+     * @param mesh Receives the vertex and index buffers
+     * @return false if the object has no CPU-generated mesh (see generateMesh())
+     */
+    bool tessellate(MeshData& mesh) const;
+
+    /**
+     * @brief Gets the number of triangles drawn for the object
+     *
+     * Computed from the shape parameters without tessellating, so it is cheap
+     * enough to sum over a whole scene every frame.
+     *
+     * @return Exact triangle count of the mesh; 0 by default
+     */
+    virtual int getTriangleCount() const;
+
+    /**
+     * @brief Gets the memory held by the object
+     *
+     * Derived classes report their own size and add any heap storage.
+     *
+     * @return Memory usage; the default covers a plain Geo3DObject
+     */
+    virtual MemoryUsage getMemoryUsage() const;
+
+    /**
+     * @brief Gets the size of the vertex and index data behind a renderer
+     *
+     * Buffers shared by several attributes are counted once. Buffers that
+     * are not filled on the frontend, such as those of Qt3D procedural
+     * meshes, are sized from their attributes.
+     *
+     * @param renderer Renderer to measure
+     * @return Size in bytes, 0 if the renderer has no geometry
+     */
+    static qint64 geometryByteSize(const Qt3DRender::QGeometryRenderer* renderer);
+
     // Qt3D Entity creation
     virtual Qt3DCore::QEntity* createEntity(Qt3DCore::QEntity* parent = nullptr);
 
+    /**
+     * @brief Creates the entity with a box of the local bounds instead of the full mesh
+     *
+     * Proxies of equal size share one renderer. Transform, material and
+     * visibility are the same as with createEntity(). Objects without bounds
+     * get their full geometry right away.
+     *
+     * @param parent Parent entity
+     * @return The entity
+     */
+    Qt3DCore::QEntity* createProxyEntity(Qt3DCore::QEntity* parent = nullptr);
+
+    // Whether the entity still shows the bounding-box proxy
+    bool hasProxyGeometry() const;
+
+    /**
+     * @brief Replaces the bounding-box proxy with the full geometry
+     *
+     * @param mesh Mesh from tessellate(), e.g. computed on a worker thread, or
+     *        nullptr to build the geometry now
+     */
+    void replaceProxyGeometry(const MeshData* mesh = nullptr);
+
+    // Entity created by createEntity(), or nullptr if none exists yet
+    Qt3DCore::QEntity* getEntity() const;
+
     // Visibility
     bool isVisible() const;
     void setVisible(bool visible);
 
+    // Deferred updates
+
+    /**
+     * @brief Checks whether property changes are waiting to be pushed to Qt3D
+     *
+     * Changes made while the owning Geo3DObjectSet is inside an edit
+     * transaction are accumulated and only pushed when the transaction commits.
+     *
+     * @return true if there are accumulated changes that have not been applied
+     */
+    bool hasPendingUpdates() const;
+
+    /**
+     * @brief Pushes all accumulated property changes to the Qt3D components
+     *
+     * Each dirty component (geometry, transform, material, visibility) is
+     * updated exactly once, regardless of how many setters touched it.
+     */
+    void applyPendingUpdates();
+
     // JSON Serialization
     virtual QJsonObject toJson() const = 0;
     virtual bool fromJson(const QJsonObject& json) = 0;
     virtual QString getObjectType() const = 0;
 
+    /**
+     * @brief Copies the object's values without any Qt3D state
+     *
+     * The copy has no entity and belongs to no set, so it can be serialized
+     * on another thread while the original is edited or deleted.
+     *
+     * @return New object of the same type, owned by the caller
+     */
+    virtual Geo3DObject* clone() const = 0;
+
+    // CBOR Serialization
+
+    /**
+     * @brief Serializes the object to a CBOR map
+     *
+     * The default implementation converts toJson(), so the binary form holds
+     * exactly the same values. Objects with large arrays override this to
+     * store them as packed typed arrays.
+     *
+     * @return QCborMap with the same content as toJson()
+     */
+    virtual QCborMap toCbor() const;
+
+    /**
+     * @brief Deserializes the object from a CBOR map written by toCbor()
+     *
+     * @param cbor Serialized object data
+     * @return true if deserialization was successful
+     */
+    virtual bool fromCbor(const QCborMap& cbor);
+
+    /**
+     * @brief Creates a Geo3DObject from CBOR data
+     *
+     * CBOR counterpart of createFromJson(), using the same factory registry.
+     *
+     * @param cbor QCborMap containing the serialized object data
+     * @return Pointer to the created object, or nullptr if creation failed
+     */
+    static Geo3DObject* createFromCbor(const QCborMap& cbor);
+
     /**
      * @brief Creates a Geo3DObject from JSON data
      *
@@ -87,26 +371,102 @@ public:
     /**
      * @brief Registers a factory function for an object type
      *
+     * The registry is thread-safe: types may be registered while other
+     * threads create objects with createFromJson() or createFromCbor().
+     *
      * @param typeName Type name identifier (e.g., "Cylinder")
      * @param factory Factory function that creates the object
      */
     static void registerObjectType(const QString& typeName, ObjectFactory factory);
 
 protected:
+    // Copies transform, material and visibility; see clone()
+    Geo3DObject(const Geo3DObject& other);
+
+    // Components that need to be pushed to Qt3D
+    enum UpdateFlag {
+        TransformUpdate = 0x1,
+        MaterialUpdate = 0x2,
+        VisibilityUpdate = 0x4,
+        GeometryUpdate = 0x8
+    };
+
     // Pure virtual method for creating geometry - must be implemented by derived classes
     virtual Qt3DRender::QGeometryRenderer* createGeometry() = 0;
 
+    /**
+     * @brief Wraps mesh buffers in a geometry renderer
+     *
+     * @param mesh Buffers from generateMesh() or the tessellation cache
+     * @return New renderer with position (and normal) and index attributes
+     */
+    static Qt3DRender::QGeometryRenderer* createGeometryFromMesh(const MeshData& mesh);
+
+    /**
+     * @brief Builds an axis-aligned box with flat normals
+     *
+     * @param minimum Minimum corner
+     * @param maximum Maximum corner
+     * @return 24 vertices and 12 triangles
+     */
+    static MeshData createBoxMesh(const QVector3D& minimum, const QVector3D& maximum);
+
+    /**
+     * @brief Marks components as changed
+     *
+     * Applies the update immediately, or defers it until commit when the
+     * owning set is inside an edit transaction. The owning set also records
+     * the object as modified for incremental saves.
+     *
+     * @param flags Combination of UpdateFlag values
+     */
+    void requestUpdate(int flags);
+
+    /**
+     * @brief Requests that the geometry be rebuilt with createGeometry()
+     *
+     * Derived classes call this when a shape parameter changes.
+     */
+    void invalidateGeometry();
+
+    /**
+     * @brief Writes the blend and cull overrides of an object record
+     *
+     * Automatic modes are left out, so records without overrides are
+     * unchanged. Derived classes call this from toJson().
+     *
+     * @param json Record to add the "blendMode" and "cullMode" keys to
+     */
+    void renderModesToJson(QJsonObject& json) const;
+
+    /**
+     * @brief Reads the overrides written by renderModesToJson()
+     *
+     * A missing key restores the automatic mode, so updating an object in
+     * place from a record also clears overrides the record no longer has.
+     *
+     * @param json Object record
+     */
+    void renderModesFromJson(const QJsonObject& json);
+
     // Update methods - called when properties change
     virtual void updateTransform();
     virtual void updateMaterial();
+    virtual void updateGeometry();
 
 
 private:
+    friend class Geo3DObjectSet;
+
     // Transform data
     QVector3D m_position;
     QVector3D m_rotation;
     QVector3D m_scale;
 
+    // Cached composition of the transform data
+    mutable QMatrix4x4 m_worldMatrix;
+    mutable bool m_worldMatrixDirty;
+
     // Material data
     QColor m_diffuseColor;
     QColor m_ambientColor;
@@ -115,15 +475,59 @@ private:
 
     float m_opacity;
 
+    BlendMode m_blendMode;
+    CullMode m_cullMode;
+
     bool m_visible;
 
-    // Qt3D components (created when needed)
-    Qt3DCore::QEntity* m_entity;
+    // Qt3D components (created when needed). The entity is tracked because
+    // deleting the scene root destroys it and its owned components.
+    QPointer<Qt3DCore::QEntity> m_entity;
     Qt3DCore::QTransform* m_transform;
-    Qt3DExtras::QPhongAlphaMaterial* m_material;
+    Qt3DRender::QMaterial* m_material;
+    Geo3DMaterialKey m_materialKey;
+    bool m_sharedMaterial;
     Qt3DRender::QGeometryRenderer* m_geometryRenderer;
+    bool m_sharedGeometry;
+    bool m_proxyGeometry;
+
+    // Pool the entity was checked out from, or nullptr if the object owns it
+    Geo3DEntityPool* m_entityPool;
+
+    // Detaches the material; shared ones go back to the set's registry, owned ones are deleted
+    void releaseMaterial();
+
+    // Takes an entity from the set's pool, or builds one without a pool
+    void checkOutEntity(Qt3DCore::QEntity* parent);
+
+    // Adds transform, material and visibility to a new entity
+    void setUpEntity();
+
+    // Attaches geometry for the current shape, shared through the set's registry when possible;
+    // a prebuilt mesh is used instead of building one
+    void acquireGeometry(const MeshData* mesh = nullptr);
+
+    // Attaches the shared bounding-box proxy
+    void acquireProxyGeometry();
+
+    // Creates the renderer, going through the set's tessellation cache when one is configured
+    Qt3DRender::QGeometryRenderer* buildGeometry();
+
+    // Detaches the geometry; shared renderers go back to the set's registry, owned ones are deleted
+    void releaseGeometry();
+
+    // Releases material and geometry and deletes the entity, removing the object from the scene
+    void releaseEntity();
+
+    // Drops the component pointers of an entity that was destroyed with its scene
+    void forgetDestroyedEntity();
 
+    // Pushes or defers components without marking the object as modified
+    void scheduleUpdate(int flags);
 
+    // Owning set (for edit transactions) and accumulated UpdateFlag values
+    Geo3DObjectSet* m_objectSet;
+    int m_pendingUpdates;
 };
 
 #endif // GEO3DOBJECT_H
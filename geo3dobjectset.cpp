@@ -1,14 +1,93 @@
 #include "geo3dobjectset.h"
 #include "geo3dobject.h"
+#include "geo3djsonstreamreader.h"
+#include "geo3dscenecontainer.h"
+#include "geo3dcompressedstream.h"
+#include "geo3dtrace.h"
 
 #include <Qt3DCore/QEntity>
+#include <Qt3DRender/QLayer>
+#include <Qt3DRender/QLayerFilter>
 #include <QJsonDocument>
 #include <QFile>
+#include <QBuffer>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
 #include <QIODevice>
+#include <QJsonArray>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QCborValue>
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
 
 
+// Below this many objects, dispatching to the thread pool costs more than it saves
+static const int s_parallelThreshold = 256;
+
+// Number of streamed JSON records that are parsed into objects together
+static const int s_loadBatchSize = 4096;
+
+// Journal records after which saveIncremental() writes a fresh snapshot
+static const int s_defaultJournalCompactionThreshold = 1024;
+
+// Applies a function to every item, spread over the global thread pool for
+// large inputs. Results are returned in the order of the items, so output
+// does not depend on scheduling.
+template <typename Result, typename Item, typename Function>
+static QVector<Result> mapInOrder(const QVector<Item>& items, Function function)
+{
+    if (items.size() < s_parallelThreshold) {
+        QVector<Result> results;
+        results.reserve(items.size());
+        for (const Item& item : items) {
+            results.append(function(item));
+        }
+        return results;
+    }
+    return QtConcurrent::blockingMapped<QVector<Result>>(items, function);
+}
+
+// Serializes every object in name order; objects are only read, never modified
+template <typename Record>
+static QVector<QPair<QString, Record>> serializeObjects(const QMap<QString, Geo3DObject*>& objects,
+                                                        Record (Geo3DObject::*serialize)() const)
+{
+    QVector<QPair<QString, Geo3DObject*>> items;
+    items.reserve(objects.size());
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+        if (it.value()) {
+            items.append(qMakePair(it.key(), it.value()));
+        }
+    }
+
+    return mapInOrder<QPair<QString, Record>>(items, [serialize](const QPair<QString, Geo3DObject*>& item) {
+        return qMakePair(item.first, (item.second->*serialize)());
+    });
+}
+
+// Creates detached objects from records; failed records yield nullptr
+template <typename Record>
+static QVector<Geo3DObject*> deserializeObjects(const QVector<Record>& records,
+                                                Geo3DObject* (*create)(const Record&))
+{
+    return mapInOrder<Geo3DObject*>(records, [create](const Record& record) {
+        return create(record);
+    });
+}
+
 Geo3DObjectSet::Geo3DObjectSet()
     : m_ownsObjects(true)
+    , m_editDepth(0)
+    , m_tessellationCache(nullptr)
+    , m_entityPool(nullptr)
+    , m_journalBaseSize(-1)
+    , m_journalBaseModified(-1)
+    , m_layersChanged(false)
+    , m_journalRecordCount(0)
+    , m_journalCompactionThreshold(s_defaultJournalCompactionThreshold)
 {
 }
 
@@ -28,16 +107,34 @@ void Geo3DObjectSet::addObject(const QString& name, Geo3DObject* object)
         removeObject(name);
     }
 
+    object->m_objectSet = this;
     m_objects.insert(name, object);
+    m_objectNames.insert(object, name);
+    m_changedNames.insert(name);
+    m_contentHashes.remove(name);
 }
 
 bool Geo3DObjectSet::removeObject(const QString& name)
 {
     auto it = m_objects.find(name);
     if (it != m_objects.end()) {
+        if (it.value()) {
+            m_pendingUpdates.remove(it.value());
+            m_objectNames.remove(it.value());
+            // Take the entity out of the scene before the object is gone
+            it.value()->releaseEntity();
+            it.value()->m_objectSet = nullptr;
+        }
+        for (auto layerIt = m_layers.begin(); layerIt != m_layers.end(); ++layerIt) {
+            if (layerIt->members.contains(name)) {
+                removeObjectFromLayer(name, layerIt.key());
+            }
+        }
         if (m_ownsObjects && it.value()) {
             delete it.value();
         }
+        m_changedNames.insert(name);
+        m_contentHashes.remove(name);
         m_objects.erase(it);
         return true;
     }
@@ -46,12 +143,34 @@ bool Geo3DObjectSet::removeObject(const QString& name)
 
 void Geo3DObjectSet::clear()
 {
-    if (m_ownsObjects) {
-        for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
+    for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
+        m_changedNames.insert(it.key());
+        if (!it.value()) {
+            continue;
+        }
+        // Take the entity out of the scene before the object is gone
+        it.value()->releaseEntity();
+        it.value()->m_objectSet = nullptr;
+        if (m_ownsObjects) {
             delete it.value();
         }
     }
     m_objects.clear();
+    m_objectNames.clear();
+    m_contentHashes.clear();
+    m_pendingUpdates.clear();
+
+    if (!m_layers.isEmpty()) {
+        m_layersChanged = true;
+    }
+
+    for (auto it = m_layers.begin(); it != m_layers.end(); ++it) {
+        if (it->node && m_layerFilter) {
+            m_layerFilter->removeLayer(it->node);
+        }
+        delete it->node.data();
+    }
+    m_layers.clear();
 }
 
 Geo3DObject* Geo3DObjectSet::getObject(const QString& name) const
@@ -80,6 +199,39 @@ bool Geo3DObjectSet::isEmpty() const
     return m_objects.isEmpty();
 }
 
+bool Geo3DObjectSet::calculateBounds(QVector3D& minimum, QVector3D& maximum) const
+{
+    bool found = false;
+    QVector3D sceneMin;
+    QVector3D sceneMax;
+
+    for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
+        QVector3D objectMin;
+        QVector3D objectMax;
+        if (!it.value() || !it.value()->getBoundingBox(objectMin, objectMax)) {
+            continue;
+        }
+
+        if (!found) {
+            sceneMin = objectMin;
+            sceneMax = objectMax;
+            found = true;
+            continue;
+        }
+
+        for (int axis = 0; axis < 3; ++axis) {
+            sceneMin[axis] = qMin(sceneMin[axis], objectMin[axis]);
+            sceneMax[axis] = qMax(sceneMax[axis], objectMax[axis]);
+        }
+    }
+
+    if (found) {
+        minimum = sceneMin;
+        maximum = sceneMax;
+    }
+    return found;
+}
+
 QMap<QString, Geo3DObject*>::iterator Geo3DObjectSet::begin()
 {
     return m_objects.begin();
@@ -111,44 +263,150 @@ QMap<QString, Geo3DObject*>::const_iterator Geo3DObjectSet::constEnd() const
 }
 
 void Geo3DObjectSet::createEntities(Qt3DCore::QEntity* parentEntity)
+{
+    GEO3D_TRACE_SCOPE("entities", "createEntities");
+    buildEntities(parentEntity, false);
+}
+
+void Geo3DObjectSet::createProxyEntities(Qt3DCore::QEntity* parentEntity)
+{
+    GEO3D_TRACE_SCOPE("entities", "createProxyEntities");
+    buildEntities(parentEntity, true);
+}
+
+void Geo3DObjectSet::buildEntities(Qt3DCore::QEntity* parentEntity, bool proxies)
 {
     if (!parentEntity) {
         return;
     }
 
+    // Shared materials, geometry and layers live under the scene root rather than any single object entity
+    m_sceneRoot = parentEntity;
+    m_materialRegistry.setParentNode(parentEntity);
+    m_geometryRegistry.setParentNode(parentEntity);
+
     for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
-        if (it.value()) {
+        if (!it.value()) {
+            continue;
+        }
+        if (proxies) {
+            it.value()->createProxyEntity(parentEntity);
+        } else {
             it.value()->createEntity(parentEntity);
         }
     }
+
+    for (auto it = m_layers.begin(); it != m_layers.end(); ++it) {
+        Qt3DRender::QLayer* node = ensureLayerNode(it.value());
+        for (const QString& name : std::as_const(it->members)) {
+            Geo3DObject* object = getObject(name);
+            if (object && object->getEntity()) {
+                object->getEntity()->addComponent(node);
+            }
+        }
+    }
+}
+
+void Geo3DObjectSet::releaseEntities()
+{
+    GEO3D_TRACE_SCOPE("entities", "releaseEntities");
+
+    for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
+        if (it.value()) {
+            it.value()->releaseEntity();
+        }
+    }
+
+    for (auto it = m_layers.begin(); it != m_layers.end(); ++it) {
+        if (it->node && m_layerFilter) {
+            m_layerFilter->removeLayer(it->node);
+        }
+        delete it->node.data();
+    }
+
+    // Every live node has been released now; what is left was either kept for
+    // the pool or died with a scene that was already destroyed. A live node
+    // that is still referenced is a leak and stays counted.
+    m_materialRegistry.purgeUnused();
+    m_geometryRegistry.purgeUnused();
+    m_materialRegistry.pruneDestroyed();
+    m_geometryRegistry.pruneDestroyed();
+    m_materialRegistry.setParentNode(nullptr);
+    m_geometryRegistry.setParentNode(nullptr);
+    m_sceneRoot = nullptr;
 }
 
 void Geo3DObjectSet::updateAllTransforms()
 {
+    EditTransaction edit(*this);
     for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
         if (it.value()) {
-            // This would trigger the transform update in the object
-            // Since updateTransform is protected, we'll call it indirectly by setting position
-            QVector3D currentPos = it.value()->getPosition();
-            it.value()->setPosition(currentPos);
+            it.value()->scheduleUpdate(Geo3DObject::TransformUpdate);
         }
     }
 }
 
 void Geo3DObjectSet::updateAllMaterials()
 {
+    EditTransaction edit(*this);
     for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
         if (it.value()) {
-            // This would trigger the material update in the object
-            // Since updateMaterial is protected, we'll call it indirectly by setting a material property
-            QColor currentColor = it.value()->getDiffuseColor();
-            it.value()->setDiffuseColor(currentColor);
+            it.value()->scheduleUpdate(Geo3DObject::MaterialUpdate);
         }
     }
 }
 
+void Geo3DObjectSet::beginEdit()
+{
+    ++m_editDepth;
+}
+
+void Geo3DObjectSet::commitEdit()
+{
+    if (m_editDepth == 0) {
+        qWarning() << "Geo3DObjectSet::commitEdit called without matching beginEdit";
+        return;
+    }
+
+    if (--m_editDepth > 0) {
+        return;
+    }
+
+    // Swap out first so updates triggered while applying are not lost
+    QSet<Geo3DObject*> pending;
+    pending.swap(m_pendingUpdates);
+    for (Geo3DObject* object : std::as_const(pending)) {
+        object->applyPendingUpdates();
+    }
+}
+
+bool Geo3DObjectSet::isEditing() const
+{
+    return m_editDepth > 0;
+}
+
+int Geo3DObjectSet::pendingUpdateCount() const
+{
+    return m_pendingUpdates.size();
+}
+
+void Geo3DObjectSet::queueUpdate(Geo3DObject* object)
+{
+    m_pendingUpdates.insert(object);
+}
+
+void Geo3DObjectSet::noteObjectChanged(Geo3DObject* object)
+{
+    auto it = m_objectNames.constFind(object);
+    if (it != m_objectNames.constEnd()) {
+        m_changedNames.insert(it.value());
+        m_contentHashes.remove(it.value());
+    }
+}
+
 void Geo3DObjectSet::setAllVisible(bool visible)
 {
+    EditTransaction edit(*this);
     for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
         if (it.value()) {
             it.value()->setVisible(visible);
@@ -164,8 +422,164 @@ void Geo3DObjectSet::setObjectVisible(const QString& name, bool visible)
     }
 }
 
+void Geo3DObjectSet::addObjectToLayer(const QString& objectName, const QString& layerName)
+{
+    Geo3DObject* object = getObject(objectName);
+    if (!object) {
+        return;
+    }
+
+    Layer& layer = m_layers[layerName];
+    if (layer.members.contains(objectName)) {
+        return;
+    }
+    layer.members.insert(objectName);
+    m_layersChanged = true;
+
+    Qt3DRender::QLayer* node = ensureLayerNode(layer);
+    if (node && object->getEntity()) {
+        object->getEntity()->addComponent(node);
+    }
+}
+
+void Geo3DObjectSet::removeObjectFromLayer(const QString& objectName, const QString& layerName)
+{
+    auto it = m_layers.find(layerName);
+    if (it == m_layers.end() || !it->members.remove(objectName)) {
+        return;
+    }
+    m_layersChanged = true;
+
+    Geo3DObject* object = getObject(objectName);
+    if (object && object->getEntity() && it->node) {
+        object->getEntity()->removeComponent(it->node);
+    }
+}
+
+void Geo3DObjectSet::removeLayer(const QString& layerName)
+{
+    auto it = m_layers.find(layerName);
+    if (it == m_layers.end()) {
+        return;
+    }
+
+    if (it->node) {
+        for (const QString& name : std::as_const(it->members)) {
+            Geo3DObject* object = getObject(name);
+            if (object && object->getEntity()) {
+                object->getEntity()->removeComponent(it->node);
+            }
+        }
+        if (m_layerFilter) {
+            m_layerFilter->removeLayer(it->node);
+        }
+        delete it->node.data();
+    }
+
+    m_layers.erase(it);
+    m_layersChanged = true;
+}
+
+QStringList Geo3DObjectSet::getLayerNames() const
+{
+    return m_layers.keys();
+}
+
+QStringList Geo3DObjectSet::getLayerMembers(const QString& layerName) const
+{
+    auto it = m_layers.constFind(layerName);
+    if (it == m_layers.constEnd()) {
+        return QStringList();
+    }
+
+    QStringList members(it->members.begin(), it->members.end());
+    members.sort();
+    return members;
+}
+
+QStringList Geo3DObjectSet::getObjectLayers(const QString& objectName) const
+{
+    QStringList layers;
+    for (auto it = m_layers.constBegin(); it != m_layers.constEnd(); ++it) {
+        if (it->members.contains(objectName)) {
+            layers.append(it.key());
+        }
+    }
+    return layers;
+}
+
+bool Geo3DObjectSet::setLayerVisible(const QString& layerName, bool visible)
+{
+    auto it = m_layers.find(layerName);
+    if (it == m_layers.end()) {
+        return false;
+    }
+
+    Layer& layer = it.value();
+    if (layer.visible == visible) {
+        return true;
+    }
+    layer.visible = visible;
+    m_layersChanged = true;
+
+    // One framegraph change; member entities are not touched
+    Qt3DRender::QLayer* node = ensureLayerNode(layer);
+    if (node && m_layerFilter) {
+        if (visible) {
+            m_layerFilter->removeLayer(node);
+        } else {
+            m_layerFilter->addLayer(node);
+        }
+    }
+    return true;
+}
+
+bool Geo3DObjectSet::isLayerVisible(const QString& layerName) const
+{
+    auto it = m_layers.constFind(layerName);
+    return (it != m_layers.constEnd()) ? it->visible : true;
+}
+
+void Geo3DObjectSet::setLayerFilter(Qt3DRender::QLayerFilter* layerFilter)
+{
+    if (m_layerFilter) {
+        for (auto it = m_layers.constBegin(); it != m_layers.constEnd(); ++it) {
+            if (it->node) {
+                m_layerFilter->removeLayer(it->node);
+            }
+        }
+    }
+
+    m_layerFilter = layerFilter;
+    if (!m_layerFilter) {
+        return;
+    }
+
+    m_layerFilter->setFilterMode(Qt3DRender::QLayerFilter::DiscardAnyMatchingLayers);
+    for (auto it = m_layers.begin(); it != m_layers.end(); ++it) {
+        if (!it->visible) {
+            Qt3DRender::QLayer* node = ensureLayerNode(it.value());
+            if (node) {
+                m_layerFilter->addLayer(node);
+            }
+        }
+    }
+}
+
+Qt3DRender::QLayer* Geo3DObjectSet::ensureLayerNode(Layer& layer)
+{
+    if (!layer.node && m_sceneRoot) {
+        layer.node = new Qt3DRender::QLayer(m_sceneRoot);
+        if (!layer.visible && m_layerFilter) {
+            m_layerFilter->addLayer(layer.node);
+        }
+    }
+    return layer.node;
+}
+
 void Geo3DObjectSet::setAllDiffuseColor(const QColor& color)
 {
+    EditTransaction edit(*this);
     for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
         if (it.value()) {
             it.value()->setDiffuseColor(color);
@@ -175,6 +589,7 @@ void Geo3DObjectSet::setAllDiffuseColor(const QColor& color)
 
 void Geo3DObjectSet::setAllScale(float uniformScale)
 {
+    EditTransaction edit(*this);
     for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
         if (it.value()) {
             it.value()->setScale(uniformScale);
@@ -184,6 +599,7 @@ void Geo3DObjectSet::setAllScale(float uniformScale)
 
 void Geo3DObjectSet::setAllScale(const QVector3D& scale)
 {
+    EditTransaction edit(*this);
     for (auto it = m_objects.begin(); it != m_objects.end(); ++it) {
         if (it.value()) {
             it.value()->setScale(scale);
@@ -191,6 +607,127 @@ void Geo3DObjectSet::setAllScale(const QVector3D& scale)
     }
 }
 
+Geo3DMaterialRegistry* Geo3DObjectSet::getMaterialRegistry()
+{
+    return &m_materialRegistry;
+}
+
+int Geo3DObjectSet::materialCount() const
+{
+    return m_materialRegistry.materialCount();
+}
+
+Geo3DGeometryRegistry* Geo3DObjectSet::getGeometryRegistry()
+{
+    return &m_geometryRegistry;
+}
+
+int Geo3DObjectSet::geometryCount() const
+{
+    return m_geometryRegistry.geometryCount();
+}
+
+Geo3DObjectSet::MemoryReport Geo3DObjectSet::memoryReport() const
+{
+    MemoryReport report;
+
+    QSet<const Qt3DRender::QGeometryRenderer*> countedMeshes;
+    for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
+        const Geo3DObject* object = it.value();
+        MemoryReport::TypeUsage& usage = report.types[object->getObjectType()];
+
+        const Geo3DObject::MemoryUsage objectUsage = object->getMemoryUsage();
+        ++usage.objects;
+        usage.parameterBytes += objectUsage.parameterBytes + it.key().capacity() * qint64(sizeof(QChar));
+        usage.vertexArrayBytes += objectUsage.vertexArrayBytes;
+
+        const Qt3DRender::QGeometryRenderer* renderer = object->m_entity ? object->m_geometryRenderer : nullptr;
+        if (renderer && !countedMeshes.contains(renderer)) {
+            countedMeshes.insert(renderer);
+            ++usage.meshes;
+            usage.meshBufferBytes += Geo3DObject::geometryByteSize(renderer);
+        }
+    }
+
+    if (m_sceneRoot) {
+        ++report.nodeCounts[QString::fromLatin1(m_sceneRoot->metaObject()->className())];
+        const QList<Qt3DCore::QNode*> nodes = m_sceneRoot->findChildren<Qt3DCore::QNode*>();
+        for (const Qt3DCore::QNode* node : nodes) {
+            ++report.nodeCounts[QString::fromLatin1(node->metaObject()->className())];
+        }
+    }
+    return report;
+}
+
+qint64 Geo3DObjectSet::MemoryReport::totalBytes() const
+{
+    qint64 total = 0;
+    for (const TypeUsage& usage : types) {
+        total += usage.totalBytes();
+    }
+    return total;
+}
+
+int Geo3DObjectSet::MemoryReport::nodeCount() const
+{
+    int count = 0;
+    for (int nodes : nodeCounts) {
+        count += nodes;
+    }
+    return count;
+}
+
+QJsonObject Geo3DObjectSet::MemoryReport::toJson() const
+{
+    QJsonObject typesJson;
+    for (auto it = types.constBegin(); it != types.constEnd(); ++it) {
+        QJsonObject usage;
+        usage["objects"] = it->objects;
+        usage["parameterBytes"] = it->parameterBytes;
+        usage["vertexArrayBytes"] = it->vertexArrayBytes;
+        usage["meshes"] = it->meshes;
+        usage["meshBufferBytes"] = it->meshBufferBytes;
+        usage["totalBytes"] = it->totalBytes();
+        typesJson[it.key()] = usage;
+    }
+
+    QJsonObject nodesJson;
+    for (auto it = nodeCounts.constBegin(); it != nodeCounts.constEnd(); ++it) {
+        nodesJson[it.key()] = it.value();
+    }
+
+    QJsonObject json;
+    json["totalBytes"] = totalBytes();
+    json["nodeCount"] = nodeCount();
+    json["types"] = typesJson;
+    json["nodes"] = nodesJson;
+    return json;
+}
+
+void Geo3DObjectSet::setTessellationCache(Geo3DTessellationCache* cache)
+{
+    m_tessellationCache = cache;
+}
+
+Geo3DTessellationCache* Geo3DObjectSet::getTessellationCache() const
+{
+    return m_tessellationCache;
+}
+
+void Geo3DObjectSet::setEntityPool(Geo3DEntityPool* pool)
+{
+    m_entityPool = pool;
+
+    // Recycled entities come back to the same materials and meshes
+    m_materialRegistry.setKeepUnused(pool != nullptr);
+    m_geometryRegistry.setKeepUnused(pool != nullptr);
+}
+
+Geo3DEntityPool* Geo3DObjectSet::getEntityPool() const
+{
+    return m_entityPool;
+}
+
 const QMap<QString, Geo3DObject*>& Geo3DObjectSet::getObjectMap() const
 {
     return m_objects;
@@ -203,18 +740,27 @@ QJsonObject Geo3DObjectSet::toJson() const
     json["objectCount"] = m_objects.size();
 
     QJsonObject objectsJson;
-    for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
-        if (it.value()) {
-            objectsJson[it.key()] = it.value()->toJson();
-        }
+    const QVector<QPair<QString, QJsonObject>> records = serializeObjects(m_objects, &Geo3DObject::toJson);
+    for (const QPair<QString, QJsonObject>& record : records) {
+        objectsJson.insert(record.first, record.second);
     }
 
     json["objects"] = objectsJson;
+
+    if (!m_layers.isEmpty()) {
+        json["layers"] = layersToJson();
+    }
+
     return json;
 }
 
+// Defined with the other version 2.0 table helpers below
+static QJsonObject expandSharedRecord(QJsonObject record, const QJsonArray& materials, const QJsonArray& shapes);
+
 bool Geo3DObjectSet::fromJson(const QJsonObject& json)
 {
+    GEO3D_TRACE_SCOPE("load", "Geo3DObjectSet::fromJson");
+
     // Clear existing objects
     clear();
 
@@ -228,65 +774,967 @@ bool Geo3DObjectSet::fromJson(const QJsonObject& json)
     }
 
     QJsonObject objectsJson = json["objects"].toObject();
+    QStringList names;
+    QVector<QJsonObject> records;
     for (auto it = objectsJson.begin(); it != objectsJson.end(); ++it) {
-        QString name = it.key();
-
         if (!it.value().isObject()) {
             continue;
         }
+        names.append(it.key());
+        records.append(it.value().toObject());
+    }
 
-        QJsonObject data = it.value().toObject();
+    // Version 2.0 records reference shared tables
+    const QJsonArray materials = json["materials"].toArray();
+    const QJsonArray shapes = json["shapes"].toArray();
 
-        // Use factory method to create object
-        Geo3DObject* object = Geo3DObject::createFromJson(data);
-        if (object) {
-            addObject(name, object);
+    // Use factory method to create objects; parsing is independent per object
+    const QVector<Geo3DObject*> objects = mapInOrder<Geo3DObject*>(records, [&materials, &shapes](const QJsonObject& record) {
+        return Geo3DObject::createFromJson(expandSharedRecord(record, materials, shapes));
+    });
+    for (int i = 0; i < objects.size(); ++i) {
+        if (objects[i]) {
+            addObject(names[i], objects[i]);
         }
     }
 
+    // Layers reference objects by name, so they are restored last
+    layersFromJson(json["layers"].toObject());
+
     return true;
 }
 
-bool Geo3DObjectSet::saveToFile(const QString& filePath) const
+QCborMap Geo3DObjectSet::toCbor() const
 {
-    QJsonObject json = toJson();
-    QJsonDocument doc(json);
+    QCborMap cbor;
+    cbor.insert(QStringLiteral("version"), QStringLiteral("1.0"));
+    cbor.insert(QStringLiteral("objectCount"), m_objects.size());
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Could not open file for writing:" << filePath;
-        return false;
+    QCborMap objectsCbor;
+    const QVector<QPair<QString, QCborMap>> records = serializeObjects(m_objects, &Geo3DObject::toCbor);
+    for (const QPair<QString, QCborMap>& record : records) {
+        objectsCbor.insert(record.first, record.second);
     }
+    cbor.insert(QStringLiteral("objects"), objectsCbor);
 
-    qint64 bytesWritten = file.write(doc.toJson());
-    file.close();
-
-    if (bytesWritten == -1) {
-        qWarning() << "Error writing to file:" << filePath;
-        return false;
+    if (!m_layers.isEmpty()) {
+        cbor.insert(QStringLiteral("layers"), QCborMap::fromJsonObject(layersToJson()));
     }
 
-    return true;
+    return cbor;
 }
 
-bool Geo3DObjectSet::loadFromFile(const QString& filePath)
+bool Geo3DObjectSet::fromCbor(const QCborMap& cbor)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not open file for reading:" << filePath;
+    // Clear existing objects
+    clear();
+
+    if (!cbor.contains(QStringLiteral("version"))) {
         return false;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
+    QCborValue objectsValue = cbor.value(QStringLiteral("objects"));
+    if (!objectsValue.isMap()) {
+        return false;
+    }
 
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    const QCborMap objectsCbor = objectsValue.toMap();
+    QStringList names;
+    QVector<QCborMap> records;
+    for (auto it = objectsCbor.constBegin(); it != objectsCbor.constEnd(); ++it) {
+        if (!it.value().isMap()) {
+            continue;
+        }
+        names.append(it.key().toString());
+        records.append(it.value().toMap());
+    }
 
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << "JSON parse error:" << error.errorString();
-        return false;
+    const QVector<Geo3DObject*> objects = deserializeObjects(records, &Geo3DObject::createFromCbor);
+    for (int i = 0; i < objects.size(); ++i) {
+        if (objects[i]) {
+            addObject(names[i], objects[i]);
+        }
     }
 
-    return fromJson(doc.object());
+    layersFromJson(cbor.value(QStringLiteral("layers")).toMap().toJsonObject());
+
+    return true;
+}
+
+QJsonObject Geo3DObjectSet::layersToJson() const
+{
+    QJsonObject layersJson;
+    for (auto it = m_layers.constBegin(); it != m_layers.constEnd(); ++it) {
+        QJsonObject layerJson;
+        layerJson["visible"] = it->visible;
+        layerJson["members"] = QJsonArray::fromStringList(getLayerMembers(it.key()));
+        layersJson[it.key()] = layerJson;
+    }
+    return layersJson;
+}
+
+void Geo3DObjectSet::layersFromJson(const QJsonObject& layersJson)
+{
+    for (auto it = layersJson.begin(); it != layersJson.end(); ++it) {
+        // Layers are stored even without members, so create them explicitly
+        if (!m_layers.contains(it.key())) {
+            m_layers.insert(it.key(), Layer());
+            m_layersChanged = true;
+        }
+
+        QJsonObject layerJson = it.value().toObject();
+        const QJsonArray members = layerJson["members"].toArray();
+        for (const QJsonValue& member : members) {
+            addObjectToLayer(member.toString(), it.key());
+        }
+        setLayerVisible(it.key(), layerJson["visible"].toBool(true));
+    }
+}
+
+Geo3DObjectSet::Snapshot Geo3DObjectSet::takeSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.objects.reserve(m_objects.size());
+    for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
+        if (it.value()) {
+            snapshot.objects.append(qMakePair(it.key(), QSharedPointer<const Geo3DObject>(it.value()->clone())));
+        }
+    }
+    snapshot.layers = layersToJson();
+    return snapshot;
+}
+
+// Members every object record has; anything else belongs to the type-specific shape
+static bool isCommonRecordKey(const QString& key)
+{
+    return key == QLatin1String("type") || key == QLatin1String("transform")
+        || key == QLatin1String("material") || key == QLatin1String("visible")
+        || key == QLatin1String("opacity") || key == QLatin1String("blendMode")
+        || key == QLatin1String("cullMode");
+}
+
+// Material and shape tables of a version 2.0 document, with lookups by compact JSON
+struct SharedRecordTables
+{
+    QJsonArray materials;
+    QJsonArray shapes;
+    QHash<QByteArray, int> materialIndex;
+    QHash<QByteArray, int> shapeIndex;
+};
+
+// Replaces a record's material and shape blocks by indices, adding new blocks to the tables
+static void shareRecord(QJsonObject& record, SharedRecordTables& tables)
+{
+    if (record.value(QLatin1String("material")).isObject()) {
+        const QJsonObject material = record.value(QLatin1String("material")).toObject();
+        const QByteArray key = QJsonDocument(material).toJson(QJsonDocument::Compact);
+        auto it = tables.materialIndex.constFind(key);
+        if (it == tables.materialIndex.constEnd()) {
+            it = tables.materialIndex.insert(key, tables.materials.size());
+            tables.materials.append(material);
+        }
+        record.insert(QStringLiteral("material"), it.value());
+    }
+
+    QJsonObject shape;
+    shape.insert(QStringLiteral("type"), record.value(QLatin1String("type")));
+    const QStringList keys = record.keys();
+    for (const QString& key : keys) {
+        if (!isCommonRecordKey(key)) {
+            shape.insert(key, record.take(key));
+        }
+    }
+    if (shape.size() > 1) {
+        const QByteArray key = QJsonDocument(shape).toJson(QJsonDocument::Compact);
+        auto it = tables.shapeIndex.constFind(key);
+        if (it == tables.shapeIndex.constEnd()) {
+            it = tables.shapeIndex.insert(key, tables.shapes.size());
+            tables.shapes.append(shape);
+        }
+        record.insert(QStringLiteral("shape"), it.value());
+    }
+}
+
+// Resolves the table references of a version 2.0 record into a plain object record
+static QJsonObject expandSharedRecord(QJsonObject record, const QJsonArray& materials, const QJsonArray& shapes)
+{
+    const QJsonValue material = record.value(QLatin1String("material"));
+    if (material.isDouble()) {
+        const int index = material.toInt(-1);
+        if (index >= 0 && index < materials.size()) {
+            // Implicitly shared: every record referencing the entry uses the same data
+            record.insert(QStringLiteral("material"), materials.at(index));
+        } else {
+            record.remove(QStringLiteral("material"));
+        }
+    }
+
+    const QJsonValue shape = record.take(QLatin1String("shape"));
+    if (shape.isDouble()) {
+        const int index = shape.toInt(-1);
+        if (index >= 0 && index < shapes.size()) {
+            const QJsonObject shapeJson = shapes.at(index).toObject();
+            for (auto it = shapeJson.constBegin(); it != shapeJson.constEnd(); ++it) {
+                if (it.key() != QLatin1String("type")) {
+                    record.insert(it.key(), it.value());
+                }
+            }
+        }
+    }
+
+    return record;
+}
+
+// True if a record refers to shared tables that must be known before it can be created
+static bool hasSharedReferences(const QJsonObject& record)
+{
+    return record.value(QLatin1String("material")).isDouble()
+        || record.value(QLatin1String("shape")).isDouble();
+}
+
+// Encodes a string as a quoted, escaped JSON string
+static QByteArray jsonString(const QString& text)
+{
+    QByteArray array = QJsonDocument(QJsonArray{text}).toJson(QJsonDocument::Compact);
+    return array.mid(1, array.size() - 2);
+}
+
+bool Geo3DObjectSet::writeJsonSnapshot(const Snapshot& snapshot, bool sharedTables, QIODevice* device)
+{
+    // The tables precede the records, so they are built in a first pass that
+    // keeps the reduced records; without tables each record is written as built
+    SharedRecordTables tables;
+    QVector<QJsonObject> sharedRecords;
+    if (sharedTables) {
+        sharedRecords.reserve(snapshot.objects.size());
+        for (const auto& entry : snapshot.objects) {
+            QJsonObject record = entry.second->toJson();
+            shareRecord(record, tables);
+            sharedRecords.append(record);
+        }
+    }
+
+    // Keys in the same (alphabetical) order QJsonDocument would produce, except
+    // that the shared tables come before the records that reference them
+    bool ok = true;
+    ok = ok && device->write("{\n") != -1;
+
+    if (!snapshot.layers.isEmpty()) {
+        ok = ok && device->write("    \"layers\": ") != -1;
+        ok = ok && device->write(QJsonDocument(snapshot.layers).toJson(QJsonDocument::Compact)) != -1;
+        ok = ok && device->write(",\n") != -1;
+    }
+
+    if (sharedTables) {
+        ok = ok && device->write("    \"materials\": ") != -1;
+        ok = ok && device->write(QJsonDocument(tables.materials).toJson(QJsonDocument::Compact)) != -1;
+        ok = ok && device->write(",\n    \"shapes\": ") != -1;
+        ok = ok && device->write(QJsonDocument(tables.shapes).toJson(QJsonDocument::Compact)) != -1;
+        ok = ok && device->write(",\n") != -1;
+    }
+
+    ok = ok && device->write("    \"objectCount\": " + QByteArray::number(snapshot.objects.size()) + ",\n") != -1;
+    ok = ok && device->write("    \"objects\": {") != -1;
+
+    for (int i = 0; ok && i < snapshot.objects.size(); ++i) {
+        const QJsonObject json = sharedTables ? sharedRecords[i] : snapshot.objects[i].second->toJson();
+
+        QByteArray record = (i == 0) ? "\n        " : ",\n        ";
+        record += jsonString(snapshot.objects[i].first);
+        record += ": ";
+        record += QJsonDocument(json).toJson(QJsonDocument::Compact);
+        ok = device->write(record) != -1;
+    }
+
+    ok = ok && device->write(snapshot.objects.isEmpty() ? "},\n" : "\n    },\n") != -1;
+    ok = ok && device->write(sharedTables ? "    \"version\": \"2.0\"\n}\n"
+                                          : "    \"version\": \"1.0\"\n}\n") != -1;
+    return ok;
+}
+
+Geo3DObjectSet::SaveResult Geo3DObjectSet::saveSnapshot(const Snapshot& snapshot, bool sharedTables,
+                                                         const QString& filePath)
+{
+    SaveResult result;
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        result.errorString = QStringLiteral("Could not open file for writing: %1 (%2)").arg(filePath, file.errorString());
+        return result;
+    }
+
+    if (!writeJsonSnapshot(snapshot, sharedTables, &file)) {
+        result.errorString = QStringLiteral("Error writing to file: %1 (%2)").arg(filePath, file.errorString());
+        file.cancelWriting();
+        return result;
+    }
+
+    if (!file.commit()) {
+        result.errorString = QStringLiteral("Error writing to file: %1 (%2)").arg(filePath, file.errorString());
+        return result;
+    }
+
+    result.success = true;
+    return result;
+}
+
+QFuture<Geo3DObjectSet::SaveResult> Geo3DObjectSet::saveToFileAsync(const QString& filePath, SceneFormat format) const
+{
+    if (format != JsonFormat && format != SharedJsonFormat) {
+        SaveResult result;
+        result.errorString = QStringLiteral("Unsupported format for background save: %1").arg(format);
+        return QtConcurrent::run([result]() { return result; });
+    }
+
+    // Copy the values on the caller's thread so the worker never touches live objects
+    const Snapshot snapshot = takeSnapshot();
+    const bool sharedTables = format == SharedJsonFormat;
+    return QtConcurrent::run([snapshot, sharedTables, filePath]() {
+        return saveSnapshot(snapshot, sharedTables, filePath);
+    });
+}
+
+bool Geo3DObjectSet::saveToFile(const QString& filePath, SceneFormat format) const
+{
+    if (format == JsonFormat || format == SharedJsonFormat) {
+        SaveResult result = saveSnapshot(takeSnapshot(), format == SharedJsonFormat, filePath);
+        if (!result.success) {
+            qWarning() << result.errorString;
+        }
+        return result.success;
+    }
+
+    if (format == ContainerFormat) {
+        return Geo3DSceneContainer::write(filePath, m_objects, QCborMap::fromJsonObject(layersToJson()));
+    }
+
+    if (format == CompressedFormat) {
+        // The JSON document is produced in memory and compressed chunk by chunk
+        QByteArray payload;
+        QBuffer buffer(&payload);
+        buffer.open(QIODevice::WriteOnly);
+        writeJsonSnapshot(takeSnapshot(), false, &buffer);
+        buffer.close();
+
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Could not open file for writing:" << filePath;
+            return false;
+        }
+        if (!Geo3DCompressedStream::write(&file, payload) || !file.commit()) {
+            qWarning() << "Error writing to file:" << filePath;
+            return false;
+        }
+        return true;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open file for writing:" << filePath;
+        return false;
+    }
+
+    if (format == CborFormat) {
+        // The self-describe tag lets loadFromFile() recognize the encoding
+        QCborStreamWriter writer(&file);
+        QCborValue(QCborKnownTags::Signature, toCbor()).toCbor(writer);
+        file.close();
+
+        if (file.error() != QFileDevice::NoError) {
+            qWarning() << "Error writing to file:" << filePath;
+            return false;
+        }
+        return true;
+    }
+
+    qWarning() << "Unsupported scene format:" << format;
+    return false;
+}
+
+bool Geo3DObjectSet::loadFromFile(const QString& filePath)
+{
+    GEO3D_TRACE_SCOPE("load", "loadFromFile");
+    if (!loadSnapshotFile(filePath)) {
+        return false;
+    }
+    m_partialSourcePath.clear();
+
+    bool journalIntact = true;
+    const int recordCount = replayJournal(filePath, journalIntact);
+    resetJournalState(filePath, recordCount);
+    if (!journalIntact) {
+        // Records appended after a torn one would be lost on the next load,
+        // so the next incremental save writes a full snapshot instead
+        m_journalBasePath.clear();
+    }
+    return true;
+}
+
+bool Geo3DObjectSet::loadSnapshotFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open file for reading:" << filePath;
+        return false;
+    }
+
+    if (Geo3DSceneContainer::isContainer(file.peek(4))) {
+        file.close();
+        Geo3DSceneContainer container;
+        if (!container.open(filePath)) {
+            return false;
+        }
+
+        QVector<int> indices(container.entryCount());
+        for (int i = 0; i < indices.size(); ++i) {
+            indices[i] = i;
+        }
+        return loadFromContainer(container, indices);
+    }
+
+    // CBOR self-describe tag 55799 encodes as d9 d9 f7
+    if (file.peek(3) == QByteArray("\xd9\xd9\xf7", 3)) {
+        QCborStreamReader reader(&file);
+        QCborValue value = QCborValue::fromCbor(reader);
+        file.close();
+
+        if (reader.lastError() != QCborError::NoError) {
+            qWarning() << "CBOR parse error:" << reader.lastError().toString();
+            return false;
+        }
+
+        return fromCbor(value.taggedValue().toMap());
+    }
+
+    if (Geo3DCompressedStream::isCompressed(file.peek(4))) {
+        // Decompressed a window of chunks at a time as the parser asks for more
+        Geo3DCompressedStream::Reader reader(&file);
+        if (!reader.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        if (!loadJsonStream(&reader)) {
+            return false;
+        }
+        if (reader.hasError()) {
+            // The document happened to end where the stream broke off
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    return loadJsonStream(&file);
+}
+
+bool Geo3DObjectSet::loadJsonStream(QIODevice* device)
+{
+    // Stream the JSON: each object is created as soon as its batch of records
+    // has been parsed, so neither the document text nor a full DOM are held in
+    // memory; compressed files are decompressed a window of chunks at a time
+    GEO3D_TRACE_SCOPE("load", "loadJsonStream");
+    clear();
+
+    Geo3DJsonStreamReader reader(device);
+    bool hasVersion = false;
+    QJsonObject layersJson;
+
+    // Shared tables of version 2.0 documents
+    QJsonArray materials;
+    QJsonArray shapes;
+    bool tablesRead = false;
+    bool needsTables = false;
+
+    // Records are parsed in batches so object creation can use the thread pool
+    QStringList batchNames;
+    QVector<QJsonObject> batchRecords;
+    auto flushBatch = [this, &batchNames, &batchRecords, &materials, &shapes]() {
+        GEO3D_TRACE_SCOPE("load", "createObjectBatch");
+        const QVector<Geo3DObject*> objects = mapInOrder<Geo3DObject*>(batchRecords, [&materials, &shapes](const QJsonObject& record) {
+            return Geo3DObject::createFromJson(expandSharedRecord(record, materials, shapes));
+        });
+        for (int i = 0; i < objects.size(); ++i) {
+            if (objects[i]) {
+                addObject(batchNames[i], objects[i]);
+            }
+        }
+        batchNames.clear();
+        batchRecords.clear();
+    };
+
+    if (reader.readNext() == Geo3DJsonStreamReader::StartObject) {
+        while (reader.readNext() == Geo3DJsonStreamReader::Name) {
+            const QString key = reader.name();
+
+            if (key == QLatin1String("objects")) {
+                if (reader.readNext() != Geo3DJsonStreamReader::StartObject) {
+                    break;
+                }
+                while (reader.readNext() == Geo3DJsonStreamReader::Name) {
+                    const QString name = reader.name();
+                    QJsonValue data = reader.readValue();
+                    if (!data.isObject()) {
+                        continue;
+                    }
+
+                    batchNames.append(name);
+                    batchRecords.append(data.toObject());
+                    needsTables = needsTables || hasSharedReferences(batchRecords.last());
+
+                    // Records referencing tables that follow them wait until the end
+                    if (batchRecords.size() >= s_loadBatchSize && (tablesRead || !needsTables)) {
+                        flushBatch();
+                    }
+                }
+                if (tablesRead || !needsTables) {
+                    flushBatch();
+                }
+            } else if (key == QLatin1String("materials")) {
+                materials = reader.readValue().toArray();
+            } else if (key == QLatin1String("shapes")) {
+                shapes = reader.readValue().toArray();
+                tablesRead = true;
+            } else if (key == QLatin1String("layers")) {
+                // Layers reference objects by name and are applied after all objects exist
+                layersJson = reader.readValue().toObject();
+            } else if (key == QLatin1String("version")) {
+                hasVersion = !reader.readValue().isUndefined();
+            } else {
+                reader.skipValue();
+            }
+        }
+    }
+
+    // Deferred records, now that the shared tables are known
+    flushBatch();
+
+    if (reader.hasError() || reader.tokenType() != Geo3DJsonStreamReader::EndObject) {
+        qWarning() << "JSON parse error:" << (reader.hasError() ? reader.errorString() : QStringLiteral("Malformed scene document"));
+        clear();
+        return false;
+    }
+
+    // Check version (for future compatibility)
+    if (!hasVersion) {
+        clear();
+        return false;
+    }
+
+    layersFromJson(layersJson);
+
+    return true;
+}
+
+bool Geo3DObjectSet::loadRegionFromFile(const QString& filePath, const QVector3D& regionMin, const QVector3D& regionMax)
+{
+    Geo3DSceneContainer container;
+    if (!container.open(filePath)) {
+        return false;
+    }
+
+    if (!loadFromContainer(container, container.findInRegion(regionMin, regionMax))) {
+        return false;
+    }
+
+    // Same test as Geo3DSceneContainer::findInRegion(), on the journaled state
+    finishPartialLoad(filePath, [&regionMin, &regionMax](const QString&, const Geo3DObject* object) {
+        QVector3D boundsMin, boundsMax;
+        return object->getBoundingBox(boundsMin, boundsMax)
+            && boundsMin.x() <= regionMax.x() && boundsMax.x() >= regionMin.x()
+            && boundsMin.y() <= regionMax.y() && boundsMax.y() >= regionMin.y()
+            && boundsMin.z() <= regionMax.z() && boundsMax.z() >= regionMin.z();
+    });
+    return true;
+}
+
+bool Geo3DObjectSet::loadPrefixFromFile(const QString& filePath, const QString& prefix)
+{
+    Geo3DSceneContainer container;
+    if (!container.open(filePath)) {
+        return false;
+    }
+
+    if (!loadFromContainer(container, container.findByPrefix(prefix))) {
+        return false;
+    }
+
+    finishPartialLoad(filePath, [&prefix](const QString& name, const Geo3DObject*) {
+        return name.startsWith(prefix);
+    });
+    return true;
+}
+
+void Geo3DObjectSet::finishPartialLoad(const QString& filePath, const ObjectFilter& filter)
+{
+    bool journalIntact = true;
+    const int recordCount = replayJournal(filePath, journalIntact, filter);
+
+    // Nothing has been edited yet, but a partial set must never be journaled
+    // against, or saved over, the complete snapshot
+    resetJournalState(filePath, recordCount);
+    m_journalBasePath.clear();
+    m_partialSourcePath = filePath;
+}
+
+bool Geo3DObjectSet::loadFromContainer(const Geo3DSceneContainer& container, const QVector<int>& indices)
+{
+    clear();
+
+    // Records are independent and read-only in the mapping, so they decode in parallel
+    const QVector<Geo3DObject*> objects = mapInOrder<Geo3DObject*>(indices, [&container](int index) {
+        return container.createObject(index);
+    });
+
+    if (objects.contains(nullptr)) {
+        qDeleteAll(objects);
+        return false;
+    }
+
+    for (int i = 0; i < objects.size(); ++i) {
+        addObject(container.entry(indices[i]).name, objects[i]);
+    }
+
+    // Members that were not loaded are skipped by addObjectToLayer()
+    layersFromJson(container.layers().toJsonObject());
+
+    return true;
+}
+
+QString Geo3DObjectSet::journalPath(const QString& filePath)
+{
+    return filePath + QStringLiteral(".journal");
+}
+
+bool Geo3DObjectSet::hasUnsavedChanges() const
+{
+    return !m_changedNames.isEmpty() || m_layersChanged;
+}
+
+bool Geo3DObjectSet::isPartiallyLoaded() const
+{
+    return !m_partialSourcePath.isEmpty();
+}
+
+void Geo3DObjectSet::setJournalCompactionThreshold(int records)
+{
+    m_journalCompactionThreshold = qMax(records, 0);
+}
+
+int Geo3DObjectSet::getJournalCompactionThreshold() const
+{
+    return m_journalCompactionThreshold;
+}
+
+bool Geo3DObjectSet::compactJournal(const QString& filePath, SceneFormat format)
+{
+    // Writing the subset would drop every object that was not loaded
+    if (isPartiallyLoaded() && QFileInfo(filePath) == QFileInfo(m_partialSourcePath)) {
+        qWarning() << "Not overwriting" << filePath << "with a partially loaded scene";
+        return false;
+    }
+
+    if (!saveToFile(filePath, format)) {
+        return false;
+    }
+
+    // The new snapshot no longer matches the journal header, so a journal that
+    // survives a failed removal is ignored on load anyway
+    QFile::remove(journalPath(filePath));
+    resetJournalState(filePath, 0);
+    return true;
+}
+
+bool Geo3DObjectSet::saveIncremental(const QString& filePath, SceneFormat format)
+{
+    // A journal is only valid on top of the exact snapshot it was started for
+    QFileInfo baseInfo(filePath);
+    if (m_journalBasePath != filePath || !baseInfo.exists()
+        || baseInfo.size() != m_journalBaseSize
+        || baseInfo.lastModified().toMSecsSinceEpoch() != m_journalBaseModified) {
+        return compactJournal(filePath, format);
+    }
+
+    if (!hasUnsavedChanges()) {
+        return true;
+    }
+
+    QStringList names(m_changedNames.begin(), m_changedNames.end());
+    names.sort();
+
+    // Encode everything first so a failure leaves the journal untouched
+    QByteArray records;
+    int recordCount = 0;
+
+    if (m_journalRecordCount == 0) {
+        QJsonObject header;
+        header["op"] = "base";
+        header["size"] = m_journalBaseSize;
+        header["modified"] = m_journalBaseModified;
+        records += QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n';
+    }
+
+    for (const QString& name : std::as_const(names)) {
+        QJsonObject record;
+        Geo3DObject* object = m_objects.value(name);
+        if (object) {
+            record["op"] = m_journaledNames.contains(name) ? "modify" : "add";
+            record["name"] = name;
+            record["object"] = object->toJson();
+        } else if (m_journaledNames.contains(name)) {
+            record["op"] = "remove";
+            record["name"] = name;
+        } else {
+            continue; // Added and removed again since the last save
+        }
+        records += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+        ++recordCount;
+    }
+
+    if (m_layersChanged) {
+        QJsonObject record;
+        record["op"] = "layers";
+        record["layers"] = layersToJson();
+        records += QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+        ++recordCount;
+    }
+
+    QFile journal(journalPath(filePath));
+    if (!journal.open(m_journalRecordCount == 0 ? QIODevice::WriteOnly : QIODevice::Append)) {
+        qWarning() << "Could not open journal for writing:" << journal.fileName();
+        return false;
+    }
+
+    qint64 bytesWritten = journal.write(records);
+    journal.close();
+    if (bytesWritten != records.size() || journal.error() != QFileDevice::NoError) {
+        qWarning() << "Error writing to journal:" << journal.fileName();
+        return false;
+    }
+
+    for (const QString& name : std::as_const(names)) {
+        if (m_objects.contains(name)) {
+            m_journaledNames.insert(name);
+        } else {
+            m_journaledNames.remove(name);
+        }
+    }
+    m_changedNames.clear();
+    m_layersChanged = false;
+    m_journalRecordCount += recordCount;
+
+    if (m_journalCompactionThreshold > 0 && m_journalRecordCount > m_journalCompactionThreshold) {
+        return compactJournal(filePath, format);
+    }
+
+    return true;
+}
+
+int Geo3DObjectSet::replayJournal(const QString& filePath, bool& intact, const ObjectFilter& filter)
+{
+    intact = true;
+    QFile journal(journalPath(filePath));
+    if (!journal.exists()) {
+        return 0;
+    }
+    if (!journal.open(QIODevice::ReadWrite)) {
+        qWarning() << "Could not open journal for reading:" << journal.fileName();
+        return 0;
+    }
+
+    QFileInfo baseInfo(filePath);
+    int recordCount = 0;
+    bool headerChecked = false;
+
+    // End of the last complete record
+    qint64 validSize = 0;
+
+    while (!journal.atEnd()) {
+        const QByteArray rawLine = journal.readLine();
+        const QByteArray line = rawLine.trimmed();
+        if (line.isEmpty()) {
+            validSize = journal.pos();
+            continue;
+        }
+
+        QJsonParseError error;
+        const QJsonObject record = rawLine.endsWith('\n')
+            ? QJsonDocument::fromJson(line, &error).object() : QJsonObject();
+        if (!rawLine.endsWith('\n') || error.error != QJsonParseError::NoError) {
+            // A save interrupted mid-append leaves a torn last record. Cut it off,
+            // or later records would be appended to it and lost with it.
+            qWarning() << "Discarding incomplete journal record in" << journal.fileName();
+            if (!journal.resize(validSize)) {
+                qWarning() << "Could not truncate journal:" << journal.fileName();
+                intact = false;
+            }
+            break;
+        }
+        validSize = journal.pos();
+
+        const QString op = record["op"].toString();
+        if (!headerChecked) {
+            if (op != QLatin1String("base")
+                || qint64(record["size"].toDouble()) != baseInfo.size()
+                || qint64(record["modified"].toDouble()) != baseInfo.lastModified().toMSecsSinceEpoch()) {
+                qWarning() << "Ignoring journal that does not belong to" << filePath;
+                return 0;
+            }
+            headerChecked = true;
+            continue;
+        }
+
+        const QString name = record["name"].toString();
+        if (op == QLatin1String("add") || op == QLatin1String("modify")) {
+            Geo3DObject* object = Geo3DObject::createFromJson(record["object"].toObject());
+            if (object && filter && !filter(name, object)) {
+                // Outside a partial load; a loaded copy may have been moved out of it
+                delete object;
+                removeObject(name);
+            } else if (object) {
+                addObject(name, object);
+            }
+        } else if (op == QLatin1String("remove")) {
+            removeObject(name);
+        } else if (op == QLatin1String("layers")) {
+            const QStringList layerNames = getLayerNames();
+            for (const QString& layerName : layerNames) {
+                removeLayer(layerName);
+            }
+            layersFromJson(record["layers"].toObject());
+        }
+        ++recordCount;
+    }
+
+    return recordCount;
+}
+
+void Geo3DObjectSet::resetJournalState(const QString& filePath, int recordCount)
+{
+    QFileInfo baseInfo(filePath);
+    m_journalBasePath = filePath;
+    m_journalBaseSize = baseInfo.size();
+    m_journalBaseModified = baseInfo.lastModified().toMSecsSinceEpoch();
+    m_journalRecordCount = recordCount;
+
+    m_journaledNames = QSet<QString>(m_objects.keyBegin(), m_objects.keyEnd());
+    m_changedNames.clear();
+    m_layersChanged = false;
+}
+
+QByteArray Geo3DObjectSet::contentHash(const QString& name, const Geo3DObject* object) const
+{
+    auto it = m_contentHashes.constFind(name);
+    if (it != m_contentHashes.constEnd()) {
+        return it.value();
+    }
+
+    const QByteArray hash = QCryptographicHash::hash(QJsonDocument(object->toJson()).toJson(QJsonDocument::Compact),
+                                                     QCryptographicHash::Sha1);
+    m_contentHashes.insert(name, hash);
+    return hash;
+}
+
+void Geo3DObjectSet::attachToScene(const QString& name, Geo3DObject* object)
+{
+    Qt3DCore::QEntity* root = qobject_cast<Qt3DCore::QEntity*>(m_sceneRoot.data());
+    if (!root) {
+        return;
+    }
+
+    object->createEntity(root);
+    for (auto it = m_layers.begin(); it != m_layers.end(); ++it) {
+        if (it->members.contains(name)) {
+            Qt3DRender::QLayer* node = ensureLayerNode(it.value());
+            if (node && object->getEntity()) {
+                object->getEntity()->addComponent(node);
+            }
+        }
+    }
+}
+
+bool Geo3DObjectSet::reloadFromFile(const QString& filePath, ReloadSummary* summary)
+{
+    // Matching the file would silently drop edits that only exist in memory
+    if (hasUnsavedChanges()) {
+        qWarning() << "Not reloading" << filePath << "over unsaved changes";
+        return false;
+    }
+
+    Geo3DObjectSet source;
+    if (!source.loadFromFile(filePath)) {
+        return false;
+    }
+
+    ReloadSummary result;
+    EditTransaction edit(*this);
+
+    // Removed objects
+    const QStringList names = getObjectNames();
+    for (const QString& name : names) {
+        if (!source.contains(name)) {
+            removeObject(name);
+            ++result.removed;
+        }
+    }
+
+    // Added and modified objects
+    for (auto it = source.m_objects.begin(); it != source.m_objects.end(); ++it) {
+        const QString& name = it.key();
+        Geo3DObject* incoming = it.value();
+        if (!incoming) {
+            continue;
+        }
+
+        const QByteArray incomingHash = source.contentHash(name, incoming);
+        Geo3DObject* live = getObject(name);
+
+        if (live && contentHash(name, live) == incomingHash) {
+            ++result.unchanged;
+            continue;
+        }
+
+        if (live && live->getObjectType() == incoming->getObjectType()) {
+            // Update in place so the entity and its components are reused
+            live->fromJson(incoming->toJson());
+            m_contentHashes.insert(name, incomingHash);
+            ++result.modified;
+            continue;
+        }
+
+        // New object, or a different type under an existing name: take it from the source set
+        source.m_objectNames.remove(incoming);
+        incoming->m_objectSet = nullptr;
+        it.value() = nullptr;
+
+        if (live) {
+            ++result.modified;
+        } else {
+            ++result.added;
+        }
+        addObject(name, incoming);
+        m_contentHashes.insert(name, incomingHash);
+        attachToScene(name, incoming);
+    }
+
+    // Layer tables are small; replace them wholesale when they differ
+    const QJsonObject layers = source.layersToJson();
+    if (layersToJson() != layers) {
+        const QStringList layerNames = getLayerNames();
+        for (const QString& layerName : layerNames) {
+            removeLayer(layerName);
+        }
+        layersFromJson(layers);
+        result.layersChanged = true;
+    }
+
+    // The live set now matches the file, including any journal replayed from it
+    resetJournalState(filePath, source.m_journalRecordCount);
+    m_partialSourcePath.clear();
+    if (source.m_journalBasePath.isEmpty()) {
+        m_journalBasePath.clear();
+    }
+
+    if (summary) {
+        *summary = result;
+    }
+    return true;
 }
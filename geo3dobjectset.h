@@ -14,10 +14,33 @@
 #include <QColor>
 #include <QVector3D>
 #include <QJsonObject>
+#include <QJsonArray>
+#include <QCborMap>
+#include <QSet>
+#include <QHash>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QVector>
+#include <QPair>
+#include <QFuture>
+#include <functional>
+
+#include "geo3dmaterialregistry.h"
+#include "geo3dgeometryregistry.h"
+
+class Geo3DSceneContainer;
+class Geo3DTessellationCache;
+class Geo3DEntityPool;
 
 QT_BEGIN_NAMESPACE
+class QIODevice;
 namespace Qt3DCore {
 class QEntity;
+class QNode;
+}
+namespace Qt3DRender {
+class QLayer;
+class QLayerFilter;
 }
 QT_END_NAMESPACE
 
@@ -49,6 +72,75 @@ class Geo3DObject;
 class Geo3DObjectSet
 {
 public:
+    /**
+     * @brief On-disk encodings supported by saveToFile()
+     *
+     * loadFromFile() detects the encoding automatically.
+     */
+    enum SceneFormat {
+        JsonFormat,  ///< JSON text with one compact record per line, same content as toJson()
+        CborFormat,  ///< Binary CBOR with the same content; large arrays are packed typed arrays
+        ContainerFormat, ///< Memory-mapped container with a bounding-box index, see Geo3DSceneContainer
+        CompressedFormat, ///< The JSON document in zlib-compressed chunks, see Geo3DCompressedStream
+        SharedJsonFormat  ///< JSON version 2.0: objects reference shared material and shape tables by index
+    };
+
+    /**
+     * @brief Outcome of a background save started with saveToFileAsync()
+     */
+    struct SaveResult
+    {
+        bool success = false;
+        QString errorString;
+    };
+
+    /**
+     * @brief What reloadFromFile() changed in the live set
+     */
+    struct ReloadSummary
+    {
+        int added = 0;
+        int removed = 0;
+        int modified = 0;
+        int unchanged = 0;
+        bool layersChanged = false;
+    };
+
+    /**
+     * @brief CPU-side memory of the set, broken down by object type
+     */
+    struct MemoryReport
+    {
+        /**
+         * @brief Memory attributed to one object type
+         *
+         * A shared mesh is attributed to the type of the first object that uses it.
+         */
+        struct TypeUsage
+        {
+            int objects = 0;
+            qint64 parameterBytes = 0;    ///< Objects, their names and shape parameters
+            qint64 vertexArrayBytes = 0;  ///< User-supplied vertex arrays (FaceObject outlines)
+            int meshes = 0;               ///< Distinct geometry renderers
+            qint64 meshBufferBytes = 0;   ///< Vertex and index buffers of those renderers
+
+            qint64 totalBytes() const { return parameterBytes + vertexArrayBytes + meshBufferBytes; }
+        };
+
+        QMap<QString, TypeUsage> types;   ///< Keyed by Geo3DObject::getObjectType()
+        QMap<QString, int> nodeCounts;    ///< Live Qt3D nodes in the scene, keyed by class name
+
+        qint64 totalBytes() const;
+        int nodeCount() const;
+
+        /**
+         * @brief Converts the report for logs and machine-readable output
+         *
+         * @return Object with "totalBytes", "types" and "nodes"
+         */
+        QJsonObject toJson() const;
+    };
+
     /**
      * @brief Default constructor
      *
@@ -135,6 +227,18 @@ public:
      */
     bool isEmpty() const;
 
+    /**
+     * @brief Computes the world-space bounds of all objects in the set
+     *
+     * Union of Geo3DObject::getBoundingBox() over every object with an
+     * extent, so rotation and scale are taken into account.
+     *
+     * @param minimum Receives the minimum corner
+     * @param maximum Receives the maximum corner
+     * @return false if no object has an extent; the corners are unchanged then
+     */
+    bool calculateBounds(QVector3D& minimum, QVector3D& maximum) const;
+
     // Iteration support
 
     /**
@@ -194,24 +298,110 @@ public:
      */
     void createEntities(Qt3DCore::QEntity* parentEntity);
 
+    /**
+     * @brief Creates Qt3D entities that show bounding-box proxies
+     *
+     * Like createEntities(), but each object gets a box of its bounds instead
+     * of its mesh, so a large scene becomes visible without tessellating.
+     * Geo3DProgressiveLoader replaces the proxies with full meshes.
+     *
+     * @param parentEntity Parent Qt3D entity under which all object entities will be created
+     */
+    void createProxyEntities(Qt3DCore::QEntity* parentEntity);
+
+    /**
+     * @brief Removes all objects from the Qt3D scene
+     *
+     * Deletes the object entities and layer nodes and returns every shared
+     * material and mesh to the registries, so the scene root can be deleted
+     * or reused without leaving nodes behind. The objects themselves are kept
+     * and can be given new entities with createEntities(). Shared nodes that
+     * are still referenced afterwards have leaked and stay counted by
+     * materialCount() and geometryCount().
+     *
+     * Call this before deleting the scene root when the set outlives it.
+     */
+    void releaseEntities();
+
     /**
      * @brief Forces an update of all object transforms
      *
-     * This method triggers transform updates for all objects by temporarily
-     * setting their position to their current position, which calls the
-     * internal updateTransform() method.
+     * Marks every object's transform as dirty inside a single edit
+     * transaction, so each transform is pushed to Qt3D exactly once.
      */
     void updateAllTransforms();
 
     /**
      * @brief Forces an update of all object materials
      *
-     * This method triggers material updates for all objects by temporarily
-     * setting their diffuse color to their current color, which calls the
-     * internal updateMaterial() method.
+     * Marks every object's material as dirty inside a single edit
+     * transaction, so each material is pushed to Qt3D exactly once.
      */
     void updateAllMaterials();
 
+    // Edit transactions
+
+    /**
+     * @brief Starts an edit transaction
+     *
+     * While a transaction is open, property changes on objects in the set are
+     * accumulated instead of being pushed to Qt3D immediately. Transactions
+     * may be nested; changes are applied when the outermost one commits.
+     *
+     * @see commitEdit(), EditTransaction
+     */
+    void beginEdit();
+
+    /**
+     * @brief Ends an edit transaction
+     *
+     * When the outermost transaction ends, every object with accumulated
+     * changes pushes them to Qt3D once, one update per dirty component.
+     *
+     * @warning Must be paired with a preceding beginEdit()
+     */
+    void commitEdit();
+
+    /**
+     * @brief Checks if an edit transaction is currently open
+     *
+     * @return true between beginEdit() and the matching outermost commitEdit()
+     */
+    bool isEditing() const;
+
+    /**
+     * @brief Gets the number of objects with changes waiting for commit
+     *
+     * @return Number of objects whose updates are deferred by the open transaction
+     */
+    int pendingUpdateCount() const;
+
+    /**
+     * @class EditTransaction
+     * @brief RAII helper that opens an edit transaction and commits it on scope exit
+     *
+     * Example usage:
+     * @code
+     * {
+     *     Geo3DObjectSet::EditTransaction edit(objectSet);
+     *     objectSet.setAllDiffuseColor(QColor::red);
+     *     objectSet.setAllScale(2.0f);
+     * } // One Qt3D update per object here
+     * @endcode
+     */
+    class EditTransaction
+    {
+    public:
+        explicit EditTransaction(Geo3DObjectSet& objectSet) : m_objectSet(objectSet) { m_objectSet.beginEdit(); }
+        ~EditTransaction() { m_objectSet.commitEdit(); }
+
+        EditTransaction(const EditTransaction&) = delete;
+        EditTransaction& operator=(const EditTransaction&) = delete;
+
+    private:
+        Geo3DObjectSet& m_objectSet;
+    };
+
     // Visibility control
 
     /**
@@ -231,6 +421,92 @@ public:
      */
     void setObjectVisible(const QString& name, bool visible);
 
+    // Visibility layers
+
+    /**
+     * @brief Adds an object to a named visibility layer
+     *
+     * The layer is created if it does not exist yet. An object may belong to
+     * several layers and is hidden while any of them is hidden.
+     *
+     * @param objectName Name of the object to add
+     * @param layerName Name of the layer (e.g. a soil class or borehole group)
+     *
+     * @note If no object with the given name exists, this function has no effect
+     */
+    void addObjectToLayer(const QString& objectName, const QString& layerName);
+
+    /**
+     * @brief Removes an object from a named visibility layer
+     *
+     * @param objectName Name of the object to remove
+     * @param layerName Name of the layer
+     */
+    void removeObjectFromLayer(const QString& objectName, const QString& layerName);
+
+    /**
+     * @brief Removes a layer; its members stay in the set and become unaffected by it
+     *
+     * @param layerName Name of the layer to remove
+     */
+    void removeLayer(const QString& layerName);
+
+    /**
+     * @brief Gets the names of all layers
+     *
+     * @return QStringList containing all layer names
+     */
+    QStringList getLayerNames() const;
+
+    /**
+     * @brief Gets the names of the objects in a layer
+     *
+     * @param layerName Name of the layer
+     * @return QStringList of member object names, empty if the layer does not exist
+     */
+    QStringList getLayerMembers(const QString& layerName) const;
+
+    /**
+     * @brief Gets the names of the layers an object belongs to
+     *
+     * @param objectName Name of the object
+     * @return QStringList of layer names
+     */
+    QStringList getObjectLayers(const QString& objectName) const;
+
+    /**
+     * @brief Shows or hides every object in a layer
+     *
+     * Hiding a layer adds its Qt3D layer to the viewer's layer filter, so the
+     * cost is a single framegraph change regardless of the member count.
+     * Per-object visibility (setObjectVisible()) is independent of layers.
+     *
+     * @param layerName Name of the layer
+     * @param visible true to show the layer, false to hide it
+     * @return false if no layer with the given name exists; layers are only
+     *         created by addObjectToLayer()
+     */
+    bool setLayerVisible(const QString& layerName, bool visible);
+
+    /**
+     * @brief Checks if a layer is visible
+     *
+     * @param layerName Name of the layer
+     * @return false if the layer is hidden, true otherwise (including unknown layers)
+     */
+    bool isLayerVisible(const QString& layerName) const;
+
+    /**
+     * @brief Sets the framegraph filter that discards hidden layers
+     *
+     * The filter is switched to discard mode and receives the Qt3D layer of
+     * every hidden layer. Typically called by the viewer when it builds its
+     * framegraph.
+     *
+     * @param layerFilter Framegraph layer filter, or nullptr to detach
+     */
+    void setLayerFilter(Qt3DRender::QLayerFilter* layerFilter);
+
     // Bulk operations
 
     /**
@@ -254,6 +530,98 @@ public:
      */
     void setAllScale(const QVector3D& scale);
 
+    // Shared materials
+
+    /**
+     * @brief Gets the registry that interns materials for objects in this set
+     *
+     * Objects in the set acquire their Qt3D material from this registry, so
+     * objects with equal diffuse, ambient, specular, shininess and opacity
+     * share a single material node.
+     *
+     * @return Pointer to the set's material registry
+     */
+    Geo3DMaterialRegistry* getMaterialRegistry();
+
+    /**
+     * @brief Gets the number of distinct Qt3D material nodes used by the set
+     *
+     * @return Number of interned materials currently alive
+     */
+    int materialCount() const;
+
+    // Shared geometry
+
+    /**
+     * @brief Gets the registry that interns geometry for objects in this set
+     *
+     * Objects with equal Geo3DObject::getShapeKey() values share one Qt3D
+     * geometry renderer acquired from this registry.
+     *
+     * @return Pointer to the set's geometry registry
+     */
+    Geo3DGeometryRegistry* getGeometryRegistry();
+
+    /**
+     * @brief Gets the number of distinct Qt3D geometry renderers used by the set
+     *
+     * @return Number of interned renderers currently alive
+     */
+    int geometryCount() const;
+
+    /**
+     * @brief Sets the on-disk cache used for generated meshes
+     *
+     * Geometry that is not shared yet is looked up in the cache before it is
+     * tessellated, and stored after tessellation on a miss.
+     *
+     * @param cache Tessellation cache, or nullptr to always tessellate
+     * @note The set does not take ownership of the cache
+     */
+    void setTessellationCache(Geo3DTessellationCache* cache);
+
+    /**
+     * @brief Gets the on-disk cache used for generated meshes
+     *
+     * @return The cache set with setTessellationCache(), or nullptr
+     */
+    Geo3DTessellationCache* getTessellationCache() const;
+
+    /**
+     * @brief Sets the pool that entities are checked out from
+     *
+     * Objects take an entity and transform from the pool instead of building
+     * them, and hand them back when they are removed or deleted. Hiding an
+     * object only disables its entity, so its material and mesh stay shared.
+     * While a pool is set, materials and meshes no object uses any more are
+     * kept for objects that are added again; releaseEntities() drops them.
+     *
+     * @param pool Entity pool, or nullptr to build and delete entities
+     * @note The set does not take ownership of the pool. Set it before
+     *       creating entities; objects return their bundles to the pool
+     *       they took them from.
+     */
+    void setEntityPool(Geo3DEntityPool* pool);
+
+    /**
+     * @brief Gets the pool that entities are checked out from
+     *
+     * @return The pool set with setEntityPool(), or nullptr
+     */
+    Geo3DEntityPool* getEntityPool() const;
+
+    // Memory accounting
+
+    /**
+     * @brief Measures the memory used by the objects and their Qt3D scene
+     *
+     * Walks every object and every node below the scene root passed to
+     * createEntities(), so it is meant for diagnostics rather than per-frame use.
+     *
+     * @return Memory per object type and Qt3D node counts per class
+     */
+    MemoryReport memoryReport() const;
+
     // Direct map access
 
     /**
@@ -277,6 +645,9 @@ public:
      * as keys and serialized data as values. Each object is serialized using
      * its toJson() method.
      *
+     * Large sets serialize their objects concurrently on the global thread
+     * pool; the result is identical to a sequential pass.
+     *
      * @return QJsonObject containing the serialized object set
      */
     QJsonObject toJson() const;
@@ -288,35 +659,403 @@ public:
      * created based on their type field and deserialized using fromJson().
      * The JSON object keys become the object names in the set.
      *
+     * Objects are created concurrently on the global thread pool for large
+     * sets and added to the set afterwards on the calling thread.
+     *
      * @param json QJsonObject containing the serialized object set
      * @return true if deserialization was successful, false on error
      */
     bool fromJson(const QJsonObject& json);
 
+    // CBOR Serialization
+
+    /**
+     * @brief Serializes the entire object set to CBOR
+     *
+     * Same structure as toJson(), with each object serialized using its
+     * toCbor() method. Converting the result back with fromCbor() reproduces
+     * exactly what fromJson(toJson()) would.
+     *
+     * @return QCborMap containing the serialized object set
+     */
+    QCborMap toCbor() const;
+
+    /**
+     * @brief Deserializes the object set from CBOR
+     *
+     * Clears the current set and loads objects created with
+     * Geo3DObject::createFromCbor().
+     *
+     * @param cbor QCborMap containing the serialized object set
+     * @return true if deserialization was successful, false on error
+     */
+    bool fromCbor(const QCborMap& cbor);
+
     // File I/O
 
     /**
-     * @brief Saves the object set to a JSON file
+     * @brief Saves the object set to a file
      *
-     * Serializes the entire object set to JSON format and writes it to the
-     * specified file path. The file will be created or overwritten.
+     * Serializes the entire object set and writes it to the specified file
+     * path. The file will be created or overwritten.
      *
      * @param filePath Path to the file where the object set should be saved
+     * @param format Encoding to write (JSON text by default)
      * @return true if the file was saved successfully, false on error
      */
-    bool saveToFile(const QString& filePath) const;
+    bool saveToFile(const QString& filePath, SceneFormat format = JsonFormat) const;
 
     /**
-     * @brief Loads the object set from a JSON file
+     * @brief Saves the object set to a JSON file on a worker thread
+     *
+     * The calling thread only copies the objects' values (see
+     * Geo3DObject::clone()); serialization, encoding and writing run on the
+     * global thread pool, so the set can be edited (or even destroyed) while
+     * the save is in progress. Each record is serialized and written on its
+     * own, so at most one record exists at a time, and the file is replaced
+     * atomically when writing succeeds.
+     *
+     * Example usage:
+     * @code
+     * auto* watcher = new QFutureWatcher<Geo3DObjectSet::SaveResult>(this);
+     * connect(watcher, &QFutureWatcherBase::finished, this, [watcher]() {
+     *     Geo3DObjectSet::SaveResult result = watcher->result();
+     *     if (!result.success) qWarning() << result.errorString;
+     *     watcher->deleteLater();
+     * });
+     * watcher->setFuture(objectSet.saveToFileAsync("scene.json"));
+     * @endcode
+     *
+     * @param filePath Path to the file where the object set should be saved
+     * @param format JsonFormat or SharedJsonFormat
+     * @return Future that finishes with the result of the save
+     */
+    QFuture<SaveResult> saveToFileAsync(const QString& filePath, SceneFormat format = JsonFormat) const;
+
+    /**
+     * @brief Loads the object set from a file
+     *
+     * Reads a scene file and deserializes the object set from it. The encoding
+     * is detected from the file contents: container files start with the
+     * Geo3DSceneContainer magic, compressed files with the
+     * Geo3DCompressedStream magic, CBOR files start with the CBOR
+     * self-describe tag, anything else is parsed as JSON. This will clear the
+     * current object set and replace it with the loaded objects.
+     *
+     * JSON is read with a streaming parser that creates each object as soon
+     * as its record has been parsed, so peak memory does not grow with the
+     * file size. Compressed files are fed to the parser as their chunks are
+     * decompressed. If the file turns out to be malformed part-way through, the
+     * set is left empty.
      *
-     * Reads a JSON file and deserializes the object set from it. This will
-     * clear the current object set and replace it with the loaded objects.
+     * If a journal written by saveIncremental() exists next to the file and
+     * belongs to this exact snapshot, its records are replayed afterwards.
      *
      * @param filePath Path to the file to load from
      * @return true if the file was loaded successfully, false on error
      */
     bool loadFromFile(const QString& filePath);
+
+    /**
+     * @brief Loads only the objects of a container file that intersect a region
+     *
+     * Uses the bounding boxes in the container index, so objects outside the
+     * region are never decoded. Layer membership is restored for the loaded
+     * objects. This will clear the current object set.
+     *
+     * The set is then marked as partially loaded (see isPartiallyLoaded())
+     * and has no unsaved changes.
+     *
+     * A journal belonging to the file is replayed for the region as well:
+     * journaled objects are added or updated when their bounding box meets
+     * the region, and removed when an update moved them out of it.
+     *
+     * @param filePath Path to a file saved with ContainerFormat
+     * @param regionMin Minimum corner of the region in world space
+     * @param regionMax Maximum corner of the region in world space
+     * @return true if the file was read successfully, false on error
+     */
+    bool loadRegionFromFile(const QString& filePath, const QVector3D& regionMin, const QVector3D& regionMax);
+
+    /**
+     * @brief Loads only the objects of a container file whose names start with a prefix
+     *
+     * This will clear the current object set. Journal records for names with
+     * the prefix are replayed, and the set is marked as partially loaded, as
+     * in loadRegionFromFile().
+     *
+     * @param filePath Path to a file saved with ContainerFormat
+     * @param prefix Object name prefix, e.g. "siteA/"
+     * @return true if the file was read successfully, false on error
+     */
+    bool loadPrefixFromFile(const QString& filePath, const QString& prefix);
+
+    /**
+     * @brief Updates the live set in place to match a scene file
+     *
+     * The file is loaded into a temporary set and compared with this one by
+     * object name and content hash. Only the differences are applied: new
+     * objects are added (and get entities if the scene has been created),
+     * missing ones are removed together with their entities, and changed ones
+     * are updated through fromJson() so their existing entities are reused.
+     * An object whose type changed is replaced. All property changes are
+     * applied in one edit transaction.
+     *
+     * Content hashes of live objects are cached and invalidated by property
+     * changes, so unchanged objects are not re-serialized on every reload.
+     *
+     * The set must not have unsaved changes (see hasUnsavedChanges()): they
+     * would be overwritten by the file and the journal state would forget
+     * them. Save them first, or load the file with loadFromFile() to discard
+     * them deliberately.
+     *
+     * @param filePath Path to the scene file, in any format loadFromFile() accepts
+     * @param summary Optional receiver for the number of changes applied
+     * @return true if the file was read successfully; false on error or when
+     *         there are unsaved changes, in which case the set is unchanged
+     */
+    bool reloadFromFile(const QString& filePath, ReloadSummary* summary = nullptr);
+
+    // Incremental saves
+
+    /**
+     * @brief Saves only what changed since the last save by appending to a journal
+     *
+     * The first call for a path (or any call after the file was rewritten by
+     * other means) writes a full snapshot with saveToFile(). Later calls append
+     * one compact JSON line per added, modified or removed object, plus one
+     * for the layer table when it changed, to journalPath(). The cost of a
+     * save therefore depends on the number of changed objects, not on the
+     * size of the scene. Once the journal holds more records than
+     * getJournalCompactionThreshold(), it is folded into a new snapshot.
+     *
+     * loadFromFile() replays the journal on top of the snapshot.
+     *
+     * A set loaded with loadRegionFromFile() or loadPrefixFromFile() is
+     * never journaled against its source file, and the full snapshot that
+     * would replace it is refused (see compactJournal()).
+     *
+     * Example usage:
+     * @code
+     * objectSet.saveIncremental("scene.json");   // Full snapshot
+     * objectSet.getObject("BH-1")->setPosition(1.0f, 0.0f, 2.0f);
+     * objectSet.saveIncremental("scene.json");   // Appends one record
+     * @endcode
+     *
+     * @param filePath Path of the snapshot file
+     * @param format Format used when a full snapshot is written
+     * @return true if the changes were saved successfully
+     */
+    bool saveIncremental(const QString& filePath, SceneFormat format = JsonFormat);
+
+    /**
+     * @brief Folds the journal into a new full snapshot and deletes it
+     *
+     * Refused for the source file of a partially loaded set, which would
+     * otherwise lose every object that was not loaded.
+     *
+     * @param filePath Path of the snapshot file
+     * @param format Format of the new snapshot
+     * @return true if the snapshot was written successfully; false on error
+     *         or when refused
+     */
+    bool compactJournal(const QString& filePath, SceneFormat format = JsonFormat);
+
+    /**
+     * @brief Gets the path of the journal that belongs to a snapshot file
+     *
+     * @param filePath Path of the snapshot file
+     * @return The snapshot path with ".journal" appended
+     */
+    static QString journalPath(const QString& filePath);
+
+    /**
+     * @brief Checks whether objects or layers changed since the last save or load
+     */
+    bool hasUnsavedChanges() const;
+
+    /**
+     * @brief Checks whether the set holds only part of its source file
+     *
+     * @return true after loadRegionFromFile() or loadPrefixFromFile(), until
+     *         the next loadFromFile() or reloadFromFile()
+     */
+    bool isPartiallyLoaded() const;
+
+    /**
+     * @brief Sets the journal size, in records, that triggers compaction
+     *
+     * @param records Number of records; 0 disables automatic compaction
+     */
+    void setJournalCompactionThreshold(int records);
+
+    /**
+     * @brief Gets the journal size, in records, that triggers compaction
+     */
+    int getJournalCompactionThreshold() const;
+
 private:
+    friend class Geo3DObject;
+
+    /**
+     * @brief Records an object whose updates are deferred until commit
+     *
+     * Called by Geo3DObject when it first becomes dirty inside a transaction.
+     *
+     * @param object Object with pending updates
+     */
+    void queueUpdate(Geo3DObject* object);
+
+    /**
+     * @brief Records that an object's serialized state changed
+     *
+     * Called by Geo3DObject whenever one of its properties is modified.
+     *
+     * @param object Modified object
+     */
+    void noteObjectChanged(Geo3DObject* object);
+
+    /**
+     * @brief Decides whether a named object belongs to a partially loaded set
+     */
+    typedef std::function<bool(const QString& name, const Geo3DObject* object)> ObjectFilter;
+
+    /**
+     * @brief Reads a snapshot file without replaying its journal
+     *
+     * @param filePath Path to the file to load from
+     * @return true if the file was loaded successfully
+     */
+    bool loadSnapshotFile(const QString& filePath);
+
+    /**
+     * @brief Replaces the set with a JSON scene document read from a device
+     *
+     * @param device Open, readable device positioned at the document
+     * @return true if the document was parsed successfully
+     */
+    bool loadJsonStream(QIODevice* device);
+
+    /**
+     * @brief Gets the cached content hash of a live object, computing it if needed
+     *
+     * @param name Object name
+     * @param object Object stored under that name
+     * @return SHA-1 of the object's compact JSON record
+     */
+    QByteArray contentHash(const QString& name, const Geo3DObject* object) const;
+
+    /**
+     * @brief Creates the entity of an object added after createEntities()
+     *
+     * @param name Object name, used to attach its layers
+     * @param object Object to attach
+     */
+    void attachToScene(const QString& name, Geo3DObject* object);
+
+    /**
+     * @brief Shared implementation of createEntities() and createProxyEntities()
+     */
+    void buildEntities(Qt3DCore::QEntity* parentEntity, bool proxies);
+
+    /**
+     * @brief Applies the journal of a snapshot file, if it belongs to that snapshot
+     *
+     * A torn last record, left by an interrupted save, is cut off so that
+     * later records are not appended to it.
+     *
+     * @param filePath Path of the snapshot file that was just loaded
+     * @param intact Set to false if a torn record could not be removed
+     * @param filter Optional test for partial loads; added or modified
+     *        objects it rejects are removed from the set instead
+     * @return Number of records applied
+     */
+    int replayJournal(const QString& filePath, bool& intact, const ObjectFilter& filter = ObjectFilter());
+
+    /**
+     * @brief Replays the journal for a partial load and marks the set as partial
+     *
+     * @param filePath Path of the container file that was just loaded
+     * @param filter Test for the objects that belong to the partial set
+     */
+    void finishPartialLoad(const QString& filePath, const ObjectFilter& filter);
+
+    /**
+     * @brief Marks the current state as saved in the snapshot at a path
+     *
+     * @param filePath Path of the snapshot file
+     * @param recordCount Number of records in its journal
+     */
+    void resetJournalState(const QString& filePath, int recordCount);
+
+    /**
+     * @brief Serializes layer membership and visibility
+     *
+     * @return QJsonObject keyed by layer name, empty if there are no layers
+     */
+    QJsonObject layersToJson() const;
+
+    /**
+     * @brief Restores layers written by layersToJson()
+     *
+     * Must be called after the member objects have been added.
+     *
+     * @param layersJson QJsonObject keyed by layer name
+     */
+    void layersFromJson(const QJsonObject& layersJson);
+
+    /**
+     * @brief Replaces the set with selected records of an open container
+     *
+     * @param container Open scene container
+     * @param indices Entry positions to load
+     * @return true if every selected record was decoded
+     */
+    bool loadFromContainer(const Geo3DSceneContainer& container, const QVector<int>& indices);
+
+    /**
+     * @brief Detached copy of the set's values, safe to hand to another thread
+     *
+     * Holds clones of the objects rather than their records, so taking it
+     * only copies shape parameters; serialization happens when it is written.
+     */
+    struct Snapshot
+    {
+        QVector<QPair<QString, QSharedPointer<const Geo3DObject>>> objects;
+        QJsonObject layers;
+    };
+
+    /**
+     * @brief Clones every object into a snapshot, in name order
+     */
+    Snapshot takeSnapshot() const;
+
+    /**
+     * @brief Streams a snapshot as JSON, serializing one object record at a time
+     *
+     * With shared tables, repeated "material" blocks are replaced by an index
+     * into a material table and type-specific shape blocks (e.g. "cylinder")
+     * by a "shape" index into a shape table. The tables are written first,
+     * so the records are serialized twice: once to build the tables and once
+     * to write them.
+     *
+     * @param snapshot State to write
+     * @param sharedTables true to write format version 2.0
+     * @param device Open, writable device
+     * @return true if every write succeeded
+     */
+    static bool writeJsonSnapshot(const Snapshot& snapshot, bool sharedTables, QIODevice* device);
+
+    /**
+     * @brief Writes a snapshot to a file, replacing it atomically on success
+     *
+     * @param snapshot State to write
+     * @param sharedTables true to write format version 2.0
+     * @param filePath Destination path
+     * @return Result with an error description on failure
+     */
+    static SaveResult saveSnapshot(const Snapshot& snapshot, bool sharedTables, const QString& filePath);
+
     /**
      * @brief Internal storage for the 3D objects
      *
@@ -331,6 +1070,119 @@ private:
      * the set is destroyed. Currently always true.
      */
     bool m_ownsObjects;
+
+    /**
+     * @brief Nesting depth of open edit transactions
+     */
+    int m_editDepth;
+
+    /**
+     * @brief Objects with changes accumulated during the open transaction
+     */
+    QSet<Geo3DObject*> m_pendingUpdates;
+
+    /**
+     * @brief Interned materials shared by the objects in this set
+     */
+    Geo3DMaterialRegistry m_materialRegistry;
+
+    /**
+     * @brief Interned geometry shared by the objects in this set
+     */
+    Geo3DGeometryRegistry m_geometryRegistry;
+
+    /**
+     * @brief Optional persistent cache of generated meshes (not owned)
+     */
+    Geo3DTessellationCache* m_tessellationCache;
+
+    /**
+     * @brief Optional pool of entity bundles (not owned)
+     */
+    Geo3DEntityPool* m_entityPool;
+
+    /**
+     * @brief A named group of objects sharing one Qt3D layer
+     */
+    struct Layer
+    {
+        QSet<QString> members;
+        bool visible = true;
+        QPointer<Qt3DRender::QLayer> node;
+    };
+
+    /**
+     * @brief Returns the Qt3D layer for a layer, creating it once a scene exists
+     */
+    Qt3DRender::QLayer* ensureLayerNode(Layer& layer);
+
+    /**
+     * @brief Visibility layers keyed by name
+     */
+    QMap<QString, Layer> m_layers;
+
+    /**
+     * @brief Framegraph filter that discards the Qt3D layers of hidden layers
+     */
+    QPointer<Qt3DRender::QLayerFilter> m_layerFilter;
+
+    /**
+     * @brief Scene root passed to createEntities(), owner of shared layer nodes
+     */
+    QPointer<Qt3DCore::QNode> m_sceneRoot;
+
+    /**
+     * @brief Reverse lookup of m_objects, used to name changed objects
+     */
+    QHash<const Geo3DObject*, QString> m_objectNames;
+
+    /**
+     * @brief Content hashes of unmodified objects, used by reloadFromFile()
+     */
+    mutable QHash<QString, QByteArray> m_contentHashes;
+
+    /**
+     * @brief Snapshot file the journal state refers to
+     */
+    QString m_journalBasePath;
+
+    /**
+     * @brief Source file of a partially loaded set, empty for a complete one
+     */
+    QString m_partialSourcePath;
+
+    /**
+     * @brief Size and modification time of the snapshot when its journal was started
+     *
+     * A journal is only valid for the exact snapshot it was started for.
+     */
+    qint64 m_journalBaseSize;
+    qint64 m_journalBaseModified;
+
+    /**
+     * @brief Names present in the snapshot plus journal
+     */
+    QSet<QString> m_journaledNames;
+
+    /**
+     * @brief Names of objects added, modified or removed since the last save
+     */
+    QSet<QString> m_changedNames;
+
+    /**
+     * @brief Whether layer membership or visibility changed since the last save
+     */
+    bool m_layersChanged;
+
+    /**
+     * @brief Number of records in the journal file
+     */
+    int m_journalRecordCount;
+
+    /**
+     * @brief Journal size that triggers compaction into a new snapshot
+     */
+    int m_journalCompactionThreshold;
 };
 
 #endif // GEO3DOBJECTSET_H
@@ -0,0 +1,206 @@
+#include "geo3dperformancemonitor.h"
+#include "geo3dobjectset.h"
+#include "geo3dobject.h"
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DRender/QGeometryRenderer>
+#include <Qt3DLogic/QFrameAction>
+#include <QTimer>
+#include <QSet>
+#include <QStringList>
+
+static const int s_defaultSampleIntervalMs = 500;
+
+// Width of the longest histogram bar in characters
+static const int s_histogramBarWidth = 30;
+
+Geo3DPerformanceMonitor::Geo3DPerformanceMonitor(Geo3DObjectSet* objectSet, Qt3DCore::QEntity* rootEntity,
+                                                 QObject* parent)
+    : QObject(parent)
+    , m_objectSet(objectSet)
+    , m_rootEntity(rootEntity)
+    , m_sampleTimer(new QTimer(this))
+    , m_lastFrameNs(-1)
+{
+    m_sampleTimer->setInterval(s_defaultSampleIntervalMs);
+    connect(m_sampleTimer, &QTimer::timeout, this, &Geo3DPerformanceMonitor::sample);
+}
+
+Geo3DPerformanceMonitor::~Geo3DPerformanceMonitor()
+{
+    delete m_frameEntity;
+}
+
+void Geo3DPerformanceMonitor::setEnabled(bool enabled)
+{
+    if (enabled == isEnabled()) {
+        return;
+    }
+
+    if (!enabled) {
+        m_sampleTimer->stop();
+        delete m_frameEntity;
+        m_frameTimes.clear();
+        return;
+    }
+
+    if (!m_rootEntity) {
+        return;
+    }
+
+    m_frameEntity = new Qt3DCore::QEntity(m_rootEntity);
+    Qt3DLogic::QFrameAction* frameAction = new Qt3DLogic::QFrameAction(m_frameEntity);
+    m_frameEntity->addComponent(frameAction);
+    connect(frameAction, &Qt3DLogic::QFrameAction::triggered, this, &Geo3DPerformanceMonitor::onFrame);
+
+    m_lastFrameNs = -1;
+    m_clock.start();
+    m_sampleTimer->start();
+    sample();
+}
+
+bool Geo3DPerformanceMonitor::isEnabled() const
+{
+    return !m_frameEntity.isNull();
+}
+
+void Geo3DPerformanceMonitor::setSampleInterval(int intervalMs)
+{
+    m_sampleTimer->setInterval(intervalMs);
+}
+
+int Geo3DPerformanceMonitor::getSampleInterval() const
+{
+    return m_sampleTimer->interval();
+}
+
+void Geo3DPerformanceMonitor::onFrame(float dt)
+{
+    Q_UNUSED(dt);
+    const qint64 now = m_clock.nsecsElapsed();
+    if (m_lastFrameNs >= 0) {
+        m_frameTimes.append((now - m_lastFrameNs) / 1.0e6);
+    }
+    m_lastFrameNs = now;
+}
+
+void Geo3DPerformanceMonitor::sample()
+{
+    Statistics statistics = collectSceneStatistics(m_objectSet, m_rootEntity);
+
+    const QVector<double>& limits = histogramBucketLimits();
+    statistics.frameTimeHistogram.fill(0, limits.size() + 1);
+    double total = 0.0;
+    for (double frameTime : std::as_const(m_frameTimes)) {
+        total += frameTime;
+        statistics.frameTimeMaxMs = qMax(statistics.frameTimeMaxMs, frameTime);
+
+        int bucket = 0;
+        while (bucket < limits.size() && frameTime > limits[bucket]) {
+            ++bucket;
+        }
+        ++statistics.frameTimeHistogram[bucket];
+    }
+    statistics.frames = int(m_frameTimes.size());
+    statistics.frameTimeMeanMs = m_frameTimes.isEmpty() ? 0.0 : total / m_frameTimes.size();
+    m_frameTimes.clear();
+
+    emit statisticsUpdated(statistics);
+}
+
+Geo3DPerformanceMonitor::Statistics Geo3DPerformanceMonitor::collectSceneStatistics(const Geo3DObjectSet* objectSet,
+                                                                                    const Qt3DCore::QEntity* rootEntity)
+{
+    Statistics statistics;
+    if (rootEntity) {
+        statistics.entities = int(rootEntity->findChildren<Qt3DCore::QEntity*>().size());
+    }
+    if (!objectSet) {
+        return statistics;
+    }
+
+    // Members of hidden layers are filtered out of the render pass
+    QSet<QString> hiddenObjects;
+    const QStringList layerNames = objectSet->getLayerNames();
+    for (const QString& layerName : layerNames) {
+        if (!objectSet->isLayerVisible(layerName)) {
+            const QStringList members = objectSet->getLayerMembers(layerName);
+            for (const QString& member : members) {
+                hiddenObjects.insert(member);
+            }
+        }
+    }
+
+    QSet<const Qt3DRender::QGeometryRenderer*> renderers;
+    for (auto it = objectSet->constBegin(); it != objectSet->constEnd(); ++it) {
+        const Geo3DObject* object = it.value();
+        ++statistics.objects;
+
+        const Qt3DCore::QEntity* entity = object->getEntity();
+        Qt3DRender::QGeometryRenderer* renderer = nullptr;
+        if (entity) {
+            const QList<Qt3DRender::QGeometryRenderer*> components =
+                entity->componentsOfType<Qt3DRender::QGeometryRenderer>();
+            if (!components.isEmpty()) {
+                renderer = components.first();
+                renderers.insert(renderer);
+            }
+        }
+
+        if (!object->isVisible() || hiddenObjects.contains(it.key())) {
+            continue;
+        }
+        ++statistics.visibleObjects;
+        statistics.triangles += object->getTriangleCount();
+        if (renderer) {
+            ++statistics.drawCalls;
+        }
+    }
+
+    statistics.geometries = int(renderers.size());
+    for (const Qt3DRender::QGeometryRenderer* renderer : std::as_const(renderers)) {
+        statistics.geometryBytes += Geo3DObject::geometryByteSize(renderer);
+    }
+    statistics.pendingUpdates = objectSet->pendingUpdateCount();
+    return statistics;
+}
+
+const QVector<double>& Geo3DPerformanceMonitor::histogramBucketLimits()
+{
+    // 120, 60, 30 and 15 Hz frame budgets and beyond
+    static const QVector<double> limits = {8.3, 16.7, 33.3, 66.7, 100.0};
+    return limits;
+}
+
+QString Geo3DPerformanceMonitor::formatStatistics(const Statistics& statistics)
+{
+    QStringList lines;
+    lines << QStringLiteral("Frame time: %1 ms mean, %2 ms max (%3 frames)")
+                 .arg(statistics.frameTimeMeanMs, 0, 'f', 1)
+                 .arg(statistics.frameTimeMaxMs, 0, 'f', 1)
+                 .arg(statistics.frames);
+
+    const QVector<double>& limits = histogramBucketLimits();
+    int largestBucket = 1;
+    for (int count : statistics.frameTimeHistogram) {
+        largestBucket = qMax(largestBucket, count);
+    }
+    for (int bucket = 0; bucket < statistics.frameTimeHistogram.size(); ++bucket) {
+        const QString label = bucket < limits.size()
+            ? QStringLiteral("<= %1").arg(limits[bucket], 5, 'f', 1)
+            : QStringLiteral(" > %1").arg(limits.last(), 5, 'f', 1);
+        const int count = statistics.frameTimeHistogram[bucket];
+        const int width = (count * s_histogramBarWidth + largestBucket - 1) / largestBucket;
+        lines << QStringLiteral("%1 ms |%2 %3").arg(label, QString(width, QChar(0x2588))).arg(count);
+    }
+
+    lines << QStringLiteral("Objects: %1 visible of %2").arg(statistics.visibleObjects).arg(statistics.objects);
+    lines << QStringLiteral("Entities: %1").arg(statistics.entities);
+    lines << QStringLiteral("Draw calls: %1 (before culling)").arg(statistics.drawCalls);
+    lines << QStringLiteral("Triangles: %1").arg(statistics.triangles);
+    lines << QStringLiteral("Geometry: %1 meshes, %2 MiB")
+                 .arg(statistics.geometries)
+                 .arg(statistics.geometryBytes / (1024.0 * 1024.0), 0, 'f', 2);
+    lines << QStringLiteral("Pending rebuilds: %1").arg(statistics.pendingUpdates);
+    return lines.join(QLatin1Char('\n'));
+}
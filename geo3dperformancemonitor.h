@@ -0,0 +1,156 @@
+/**
+ * @file geo3dperformancemonitor.h
+ * @brief Header file for the Geo3DPerformanceMonitor class
+ */
+
+#ifndef GEO3DPERFORMANCEMONITOR_H
+#define GEO3DPERFORMANCEMONITOR_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QElapsedTimer>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+namespace Qt3DCore {
+class QEntity;
+}
+QT_END_NAMESPACE
+
+class Geo3DObjectSet;
+
+/**
+ * @class Geo3DPerformanceMonitor
+ * @brief Samples frame times and scene statistics for a live performance overlay
+ *
+ * While enabled, the monitor ticks once per frame through a
+ * Qt3DLogic::QFrameAction to build a frame-time histogram, and walks the
+ * scene at a fixed interval to count visible objects, entities, draw calls,
+ * triangles, distinct geometry and pending rebuilds. The results are
+ * published with statisticsUpdated().
+ *
+ * A disabled monitor has no frame entity and no timer, so it costs nothing
+ * per frame and never touches the scene.
+ *
+ * Example usage:
+ * @code
+ * Geo3DPerformanceMonitor* monitor = new Geo3DPerformanceMonitor(&objectSet, rootEntity, window);
+ * connect(monitor, &Geo3DPerformanceMonitor::statisticsUpdated, label, [label](const auto& statistics) {
+ *     label->setText(Geo3DPerformanceMonitor::formatStatistics(statistics));
+ * });
+ * monitor->setEnabled(true);
+ * @endcode
+ */
+class Geo3DPerformanceMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief One sample of frame and scene statistics
+     */
+    struct Statistics
+    {
+        // Frames since the previous sample
+        int frames = 0;
+        double frameTimeMeanMs = 0.0;
+        double frameTimeMaxMs = 0.0;
+        QVector<int> frameTimeHistogram;  ///< Frame counts per bucket of histogramBucketLimits()
+
+        int objects = 0;
+        int visibleObjects = 0;           ///< Visible objects in visible layers
+        int entities = 0;                 ///< Qt3D entities below the scene root
+        int drawCalls = 0;                ///< Visible objects with geometry, before frustum culling
+        qint64 triangles = 0;             ///< Triangles of the visible objects
+        int geometries = 0;               ///< Distinct geometry renderers in use
+        qint64 geometryBytes = 0;         ///< Size of the vertex and index data of those renderers
+        int pendingUpdates = 0;           ///< Objects waiting for an edit transaction to commit
+    };
+
+    /**
+     * @brief Creates a disabled monitor for a scene
+     *
+     * @param objectSet Objects shown in the scene
+     * @param rootEntity Scene root; the monitor's frame entity is added below it
+     * @param parent QObject parent
+     */
+    explicit Geo3DPerformanceMonitor(Geo3DObjectSet* objectSet, Qt3DCore::QEntity* rootEntity,
+                                     QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Removes the frame entity from the scene if the monitor is enabled.
+     */
+    ~Geo3DPerformanceMonitor();
+
+    /**
+     * @brief Starts or stops sampling
+     *
+     * @param enabled true to add the frame entity and start the sample timer
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * @brief Sets how often the scene statistics are sampled
+     *
+     * @param intervalMs Sample interval in milliseconds (default 500)
+     */
+    void setSampleInterval(int intervalMs);
+    int getSampleInterval() const;
+
+    /**
+     * @brief Counts the scene statistics of an object set
+     *
+     * Frame fields are left empty. Triangle counts come from
+     * Geo3DObject::getTriangleCount(); geometry sizes from the attributes of
+     * the renderers attached to the entities.
+     *
+     * @param objectSet Objects to count
+     * @param rootEntity Scene root for the entity count, may be nullptr
+     * @return Scene statistics
+     */
+    static Statistics collectSceneStatistics(const Geo3DObjectSet* objectSet, const Qt3DCore::QEntity* rootEntity);
+
+    /**
+     * @brief Gets the upper limits of the frame-time histogram buckets
+     *
+     * The last bucket collects every frame above the last limit.
+     *
+     * @return Limits in milliseconds, in ascending order
+     */
+    static const QVector<double>& histogramBucketLimits();
+
+    /**
+     * @brief Formats statistics as text for an overlay
+     *
+     * @param statistics Sample to format
+     * @return Multi-line text with a bar per histogram bucket
+     */
+    static QString formatStatistics(const Statistics& statistics);
+
+signals:
+    /**
+     * @brief Emitted after each sample
+     */
+    void statisticsUpdated(const Geo3DPerformanceMonitor::Statistics& statistics);
+
+private slots:
+    void onFrame(float dt);
+    void sample();
+
+private:
+    Geo3DObjectSet* m_objectSet;
+    QPointer<Qt3DCore::QEntity> m_rootEntity;
+    QPointer<Qt3DCore::QEntity> m_frameEntity;
+    QTimer* m_sampleTimer;
+
+    // Frame times accumulated since the last sample
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameNs;
+    QVector<double> m_frameTimes;
+};
+
+#endif // GEO3DPERFORMANCEMONITOR_H
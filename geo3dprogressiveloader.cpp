@@ -0,0 +1,218 @@
+#include "geo3dprogressiveloader.h"
+#include "geo3dobjectset.h"
+#include "geo3dtrace.h"
+
+#include <Qt3DCore/QEntity>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QHash>
+#include <QTimer>
+
+static const int s_defaultFrameBudgetMs = 8;
+
+Geo3DProgressiveLoader::Geo3DProgressiveLoader(Geo3DObjectSet* objectSet, QObject* parent)
+    : QObject(parent)
+    , m_objectSet(objectSet)
+    , m_sliceTimer(new QTimer(this))
+    , m_frameBudgetMs(s_defaultFrameBudgetMs)
+    , m_nextReadyGroup(0)
+    , m_nextMember(0)
+    , m_totalCount(0)
+    , m_upgradedCount(0)
+    , m_running(false)
+    , m_finishedMs(-1)
+{
+    // One slice per event loop pass, so rendering and input run in between
+    m_sliceTimer->setInterval(0);
+    connect(m_sliceTimer, &QTimer::timeout, this, &Geo3DProgressiveLoader::upgradeSlice);
+    connect(&m_watcher, &QFutureWatcher<GroupMesh>::resultsReadyAt, this, &Geo3DProgressiveLoader::onMeshesReady);
+}
+
+Geo3DProgressiveLoader::~Geo3DProgressiveLoader()
+{
+    m_watcher.cancel();
+    m_watcher.waitForFinished();
+}
+
+void Geo3DProgressiveLoader::start(Qt3DCore::QEntity* rootEntity)
+{
+    if (!m_objectSet || !rootEntity || m_running) {
+        return;
+    }
+    GEO3D_TRACE_SCOPE("viewer", "startProgressiveLoad");
+
+    m_clock.start();
+    m_finishedMs = -1;
+    m_objectSet->createProxyEntities(rootEntity);
+
+    // One tessellation per distinct shape; objects without a key are meshed alone
+    m_groups.clear();
+    QHash<QByteArray, int> groupByKey;
+    for (auto it = m_objectSet->constBegin(); it != m_objectSet->constEnd(); ++it) {
+        Geo3DObject* object = it.value();
+        if (!object || !object->hasProxyGeometry()) {
+            continue;
+        }
+
+        const QByteArray key = object->getShapeKey();
+        auto group = key.isEmpty() ? groupByKey.end() : groupByKey.find(key);
+        if (group == groupByKey.end()) {
+            Group newGroup;
+            newGroup.representative = object;
+            m_groups.append(newGroup);
+            if (!key.isEmpty()) {
+                group = groupByKey.insert(key, int(m_groups.size()) - 1);
+            }
+        }
+        const int index = (group == groupByKey.end()) ? int(m_groups.size()) - 1 : group.value();
+        m_groups[index].members.append(object);
+    }
+
+    m_totalCount = 0;
+    for (const Group& group : std::as_const(m_groups)) {
+        m_totalCount += int(group.members.size());
+    }
+    m_upgradedCount = 0;
+    m_readyGroups.clear();
+    m_readyGroups.reserve(m_groups.size());
+    m_nextReadyGroup = 0;
+    m_nextMember = 0;
+    m_running = true;
+
+    m_watcher.setFuture(QtConcurrent::mapped(m_groups, [](const Group& group) {
+        GEO3D_TRACE_SCOPE("tessellation", "backgroundTessellate");
+        GroupMesh result;
+        result.valid = group.representative->tessellate(result.mesh);
+        return result;
+    }));
+    m_sliceTimer->start();
+}
+
+void Geo3DProgressiveLoader::finishNow()
+{
+    if (!m_running) {
+        return;
+    }
+
+    m_watcher.waitForFinished();
+
+    // Results may be reported without their signal having been delivered yet
+    QVector<bool> queued(m_groups.size(), false);
+    for (int group : std::as_const(m_readyGroups)) {
+        queued[group] = true;
+    }
+    for (int group = 0; group < m_groups.size(); ++group) {
+        if (!queued[group]) {
+            m_readyGroups.append(group);
+        }
+    }
+
+    QElapsedTimer unlimited;
+    unlimited.start();
+    while (m_nextReadyGroup < m_readyGroups.size()) {
+        upgradeGroup(m_readyGroups[m_nextReadyGroup], unlimited, -1);
+        ++m_nextReadyGroup;
+        m_nextMember = 0;
+    }
+    finish();
+}
+
+bool Geo3DProgressiveLoader::isRunning() const
+{
+    return m_running;
+}
+
+void Geo3DProgressiveLoader::setFrameBudget(int budgetMs)
+{
+    m_frameBudgetMs = qMax(1, budgetMs);
+}
+
+int Geo3DProgressiveLoader::getFrameBudget() const
+{
+    return m_frameBudgetMs;
+}
+
+int Geo3DProgressiveLoader::totalCount() const
+{
+    return m_totalCount;
+}
+
+int Geo3DProgressiveLoader::upgradedCount() const
+{
+    return m_upgradedCount;
+}
+
+qint64 Geo3DProgressiveLoader::elapsedMs() const
+{
+    if (m_finishedMs >= 0) {
+        return m_finishedMs;
+    }
+    return m_clock.isValid() ? m_clock.elapsed() : 0;
+}
+
+void Geo3DProgressiveLoader::onMeshesReady(int begin, int end)
+{
+    if (!m_running) {
+        return;
+    }
+
+    for (int group = begin; group < end; ++group) {
+        m_readyGroups.append(group);
+    }
+    if (!m_sliceTimer->isActive()) {
+        m_sliceTimer->start();
+    }
+}
+
+void Geo3DProgressiveLoader::upgradeSlice()
+{
+    GEO3D_TRACE_SCOPE("viewer", "upgradeProxies");
+
+    QElapsedTimer budgetTimer;
+    budgetTimer.start();
+    const qint64 budgetNs = qint64(m_frameBudgetMs) * 1000000;
+
+    const int upgradedBefore = m_upgradedCount;
+    while (m_nextReadyGroup < m_readyGroups.size() && budgetTimer.nsecsElapsed() < budgetNs) {
+        if (!upgradeGroup(m_readyGroups[m_nextReadyGroup], budgetTimer, budgetNs)) {
+            break;
+        }
+        ++m_nextReadyGroup;
+        m_nextMember = 0;
+    }
+    if (m_upgradedCount != upgradedBefore) {
+        emit progress(m_upgradedCount, m_totalCount);
+    }
+
+    if (m_nextReadyGroup == m_groups.size()) {
+        finish();
+    } else if (m_nextReadyGroup == m_readyGroups.size()) {
+        // Nothing left to upload until more meshes are ready
+        m_sliceTimer->stop();
+    }
+}
+
+bool Geo3DProgressiveLoader::upgradeGroup(int group, const QElapsedTimer& budgetTimer, qint64 budgetNs)
+{
+    const GroupMesh result = m_watcher.future().resultAt(group);
+    const QVector<Geo3DObject*>& members = m_groups[group].members;
+
+    while (m_nextMember < members.size()) {
+        members[m_nextMember]->replaceProxyGeometry(result.valid ? &result.mesh : nullptr);
+        ++m_nextMember;
+        ++m_upgradedCount;
+
+        if (budgetNs >= 0 && budgetTimer.nsecsElapsed() >= budgetNs && m_nextMember < members.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Geo3DProgressiveLoader::finish()
+{
+    m_sliceTimer->stop();
+    m_running = false;
+    m_finishedMs = m_clock.elapsed();
+    emit progress(m_upgradedCount, m_totalCount);
+    emit finished();
+}
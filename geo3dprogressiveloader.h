@@ -0,0 +1,160 @@
+/**
+ * @file geo3dprogressiveloader.h
+ * @brief Header file for the Geo3DProgressiveLoader class
+ */
+
+#ifndef GEO3DPROGRESSIVELOADER_H
+#define GEO3DPROGRESSIVELOADER_H
+
+#include "geo3dobject.h"
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QVector>
+#include <QElapsedTimer>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+namespace Qt3DCore {
+class QEntity;
+}
+QT_END_NAMESPACE
+
+class Geo3DObjectSet;
+
+/**
+ * @class Geo3DProgressiveLoader
+ * @brief Shows a scene as bounding-box proxies first and swaps in full meshes as they are tessellated
+ *
+ * start() creates proxy entities for the whole set, which is cheap, so the
+ * scene can be rendered and navigated immediately. Objects are grouped by
+ * shape key and one mesh per group is tessellated on the global thread pool
+ * (through the set's tessellation cache when one is configured). The
+ * finished meshes are uploaded on the GUI thread in slices that fit a frame
+ * budget, so the view stays interactive while detail streams in.
+ *
+ * Objects that rely on a Qt3D procedural mesh have nothing to tessellate on
+ * the CPU; their geometry is created on the GUI thread in the same slices.
+ *
+ * Objects must not be removed from the set while the loader runs; call
+ * finishNow() before editing the set.
+ *
+ * Example usage:
+ * @code
+ * Geo3DProgressiveLoader* loader = new Geo3DProgressiveLoader(&objectSet, window);
+ * connect(loader, &Geo3DProgressiveLoader::finished, [loader]() {
+ *     qDebug() << "Full detail after" << loader->elapsedMs() << "ms";
+ * });
+ * loader->start(rootEntity);
+ * @endcode
+ */
+class Geo3DProgressiveLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Creates an idle loader for an object set
+     *
+     * @param objectSet Objects to display
+     * @param parent QObject parent
+     */
+    explicit Geo3DProgressiveLoader(Geo3DObjectSet* objectSet, QObject* parent = nullptr);
+
+    /**
+     * @brief Destructor
+     *
+     * Cancels tessellation that has not started and waits for running work.
+     * Objects that were not upgraded keep their proxies.
+     */
+    ~Geo3DProgressiveLoader();
+
+    /**
+     * @brief Creates the proxy entities and starts tessellating in the background
+     *
+     * @param rootEntity Parent of the object entities
+     */
+    void start(Qt3DCore::QEntity* rootEntity);
+
+    /**
+     * @brief Replaces every remaining proxy right away
+     *
+     * Waits for the background tessellation and upgrades all objects on the
+     * calling thread. Emits finished() if the loader was running.
+     */
+    void finishNow();
+
+    bool isRunning() const;
+
+    /**
+     * @brief Sets the time spent uploading meshes per event loop pass
+     *
+     * @param budgetMs Milliseconds per slice (default 8)
+     */
+    void setFrameBudget(int budgetMs);
+    int getFrameBudget() const;
+
+    // Objects that started as proxies and how many of them show full meshes
+    int totalCount() const;
+    int upgradedCount() const;
+
+    /**
+     * @brief Gets the time since start()
+     *
+     * @return Milliseconds, or the total loading time once finished
+     */
+    qint64 elapsedMs() const;
+
+signals:
+    /**
+     * @brief Emitted after each slice of upgraded objects
+     */
+    void progress(int upgraded, int total);
+
+    /**
+     * @brief Emitted when every proxy has been replaced
+     */
+    void finished();
+
+private slots:
+    void onMeshesReady(int begin, int end);
+    void upgradeSlice();
+
+private:
+    // Objects with the same shape key, sharing one tessellated mesh
+    struct Group
+    {
+        Geo3DObject* representative = nullptr;
+        QVector<Geo3DObject*> members;
+    };
+
+    // Mesh of a group, or no mesh if the objects build their geometry on the GUI thread
+    struct GroupMesh
+    {
+        bool valid = false;
+        Geo3DObject::MeshData mesh;
+    };
+
+    // Upgrades all members of a group, returning false if the budget ran out first
+    bool upgradeGroup(int group, const QElapsedTimer& budgetTimer, qint64 budgetNs);
+    void finish();
+
+    Geo3DObjectSet* m_objectSet;
+    QVector<Group> m_groups;
+    QFutureWatcher<GroupMesh> m_watcher;
+    QTimer* m_sliceTimer;
+    int m_frameBudgetMs;
+
+    // Groups whose meshes are ready, in completion order, and the next member to upgrade
+    QVector<int> m_readyGroups;
+    int m_nextReadyGroup;
+    int m_nextMember;
+
+    int m_totalCount;
+    int m_upgradedCount;
+    bool m_running;
+    QElapsedTimer m_clock;
+    qint64 m_finishedMs;
+};
+
+#endif // GEO3DPROGRESSIVELOADER_H
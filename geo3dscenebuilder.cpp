@@ -0,0 +1,105 @@
+#include "geo3dscenebuilder.h"
+#include "geo3dobjectset.h"
+
+#include <Qt3DCore/QEntity>
+#include <Qt3DCore/QTransform>
+#include <Qt3DRender/QCamera>
+#include <Qt3DRender/QCameraLens>
+#include <Qt3DRender/QCameraSelector>
+#include <Qt3DRender/QClearBuffers>
+#include <Qt3DRender/QFilterKey>
+#include <Qt3DRender/QFrustumCulling>
+#include <Qt3DRender/QLayerFilter>
+#include <Qt3DRender/QPointLight>
+#include <Qt3DRender/QRenderSurfaceSelector>
+#include <Qt3DRender/QTechniqueFilter>
+#include <Qt3DRender/QViewport>
+#include <QColor>
+
+Qt3DRender::QRenderSurfaceSelector* Geo3DSceneBuilder::createFrameGraph(QObject* surface, Qt3DCore::QEntity* camera,
+                                                                        Qt3DRender::QLayerFilter** layerFilter)
+{
+    Qt3DRender::QRenderSurfaceSelector* surfaceSelector = new Qt3DRender::QRenderSurfaceSelector();
+    surfaceSelector->setSurface(surface);
+    Qt3DRender::QViewport* viewport = new Qt3DRender::QViewport(surfaceSelector);
+    Qt3DRender::QCameraSelector* cameraSelector = new Qt3DRender::QCameraSelector(viewport);
+    cameraSelector->setCamera(camera);
+    Qt3DRender::QClearBuffers* clearBuffers = new Qt3DRender::QClearBuffers(cameraSelector);
+    clearBuffers->setBuffers(Qt3DRender::QClearBuffers::ColorDepthBuffer);
+    clearBuffers->setClearColor(QColor(QRgb(0x4d4d4f)));
+
+    // Matches the filter key of the forward techniques, as QForwardRenderer does
+    Qt3DRender::QTechniqueFilter* techniqueFilter = new Qt3DRender::QTechniqueFilter(clearBuffers);
+    Qt3DRender::QFilterKey* forwardKey = new Qt3DRender::QFilterKey(techniqueFilter);
+    forwardKey->setName(QStringLiteral("renderingStyle"));
+    forwardKey->setValue(QStringLiteral("forward"));
+    techniqueFilter->addMatch(forwardKey);
+
+    Qt3DRender::QLayerFilter* filter = new Qt3DRender::QLayerFilter(techniqueFilter);
+    new Qt3DRender::QFrustumCulling(filter);
+
+    if (layerFilter) {
+        *layerFilter = filter;
+    }
+    return surfaceSelector;
+}
+
+Qt3DCore::QEntity* Geo3DSceneBuilder::createScene(Geo3DObjectSet* objectSet, Qt3DRender::QLayerFilter* layerFilter,
+                                                  Qt3DRender::QCamera* camera, bool createObjectEntities)
+{
+    Qt3DCore::QEntity* rootEntity = new Qt3DCore::QEntity();
+
+    if (objectSet) {
+        objectSet->setLayerFilter(layerFilter);
+        if (createObjectEntities) {
+            objectSet->createEntities(rootEntity);
+        }
+    }
+
+    QVector3D minBound, maxBound;
+    sceneBounds(objectSet, minBound, maxBound);
+    const QVector3D center = (minBound + maxBound) / 2.0f;
+    const QVector3D sceneSize = maxBound - minBound;
+    const float maxDimension = qMax(qMax(sceneSize.x(), sceneSize.y()), sceneSize.z());
+
+    if (camera) {
+        frameCamera(camera, minBound, maxBound);
+    }
+
+    // Light - position it relative to scene
+    Qt3DCore::QEntity* lightEntity = new Qt3DCore::QEntity(rootEntity);
+    Qt3DRender::QPointLight* light = new Qt3DRender::QPointLight(lightEntity);
+    light->setColor("white");
+    light->setIntensity(1.5f);
+    lightEntity->addComponent(light);
+    Qt3DCore::QTransform* lightTransform = new Qt3DCore::QTransform(lightEntity);
+    lightTransform->setTranslation(center + QVector3D(maxDimension, maxDimension, maxDimension));
+    lightEntity->addComponent(lightTransform);
+
+    return rootEntity;
+}
+
+void Geo3DSceneBuilder::sceneBounds(const Geo3DObjectSet* objectSet, QVector3D& minimum, QVector3D& maximum)
+{
+    // Exact world-space boxes of the objects; a fixed box when nothing has an extent
+    if (!objectSet || !objectSet->calculateBounds(minimum, maximum)) {
+        minimum = QVector3D(-5, -5, -5);
+        maximum = QVector3D(5, 5, 5);
+    }
+}
+
+void Geo3DSceneBuilder::frameCamera(Qt3DRender::QCamera* camera, const QVector3D& minimum, const QVector3D& maximum)
+{
+    const QVector3D center = (minimum + maximum) / 2.0f;
+    const QVector3D sceneSize = maximum - minimum;
+    const float maxDimension = qMax(qMax(sceneSize.x(), sceneSize.y()), sceneSize.z());
+
+    // Camera distance with some margin
+    const float cameraDistance = maxDimension * 1.5f;
+    camera->lens()->setPerspectiveProjection(45.0f, 16.0f / 9.0f, 0.1f, cameraDistance * 10.0f);
+
+    // Look at the scene center from an angle
+    camera->setPosition(center + QVector3D(cameraDistance * 0.7f, cameraDistance * 0.5f, cameraDistance * 0.7f));
+    camera->setUpVector(QVector3D(0, 1, 0));
+    camera->setViewCenter(center);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file geo3dscenebuilder.h
+ * @brief Header file for the Geo3DSceneBuilder class
+ */
+
+#ifndef GEO3DSCENEBUILDER_H
+#define GEO3DSCENEBUILDER_H
+
+#include <QVector3D>
+
+QT_BEGIN_NAMESPACE
+class QObject;
+namespace Qt3DCore {
+class QEntity;
+}
+namespace Qt3DRender {
+class QCamera;
+class QLayerFilter;
+class QRenderSurfaceSelector;
+}
+QT_END_NAMESPACE
+
+class Geo3DObjectSet;
+
+/**
+ * @class Geo3DSceneBuilder
+ * @brief Builds the Qt3D framegraph and entity tree used to display an object set
+ *
+ * Qt3DViewer and the frame benchmark both build their scenes here, so the
+ * benchmark measures exactly the tree the viewer renders. Interactive parts
+ * such as the camera controller are left to the caller.
+ *
+ * Example usage:
+ * @code
+ * Qt3DRender::QLayerFilter* layerFilter = nullptr;
+ * window->setActiveFrameGraph(Geo3DSceneBuilder::createFrameGraph(window, window->camera(), &layerFilter));
+ * window->setRootEntity(Geo3DSceneBuilder::createScene(objectSet, layerFilter, window->camera()));
+ * @endcode
+ */
+class Geo3DSceneBuilder
+{
+public:
+    /**
+     * @brief Creates the framegraph
+     *
+     * Same nodes as QForwardRenderer: a technique filter on
+     * renderingStyle=forward, so the Qt3DExtras materials select their
+     * forward techniques, with surface selector, viewport, camera selector
+     * and clear buffers. A layer filter that discards hidden visibility
+     * layers in one place sits before the frustum culling.
+     *
+     * @param surface Window or offscreen surface to render to
+     * @param camera Camera entity to render from
+     * @param layerFilter Optionally receives the layer filter for Geo3DObjectSet::setLayerFilter()
+     * @return Root of the framegraph, without a parent
+     */
+    static Qt3DRender::QRenderSurfaceSelector* createFrameGraph(QObject* surface, Qt3DCore::QEntity* camera,
+                                                                Qt3DRender::QLayerFilter** layerFilter = nullptr);
+
+    /**
+     * @brief Creates the entity tree for an object set
+     *
+     * Creates the objects' entities under a new root entity, frames the
+     * camera on the scene bounds and adds a point light above the scene.
+     *
+     * @param objectSet Objects to display
+     * @param layerFilter Filter from createFrameGraph(), or nullptr
+     * @param camera Camera to position, or nullptr to leave it unchanged
+     * @param createObjectEntities false to leave the object entities to the
+     *        caller, e.g. a Geo3DProgressiveLoader
+     * @return Root entity, without a parent
+     */
+    static Qt3DCore::QEntity* createScene(Geo3DObjectSet* objectSet, Qt3DRender::QLayerFilter* layerFilter,
+                                          Qt3DRender::QCamera* camera, bool createObjectEntities = true);
+
+    /**
+     * @brief Gets the bounds used to frame the scene
+     *
+     * @param objectSet Objects to enclose, or nullptr
+     * @param minimum Receives the minimum corner
+     * @param maximum Receives the maximum corner; a 10 unit cube around the
+     *        origin is used when no object has an extent
+     */
+    static void sceneBounds(const Geo3DObjectSet* objectSet, QVector3D& minimum, QVector3D& maximum);
+
+    /**
+     * @brief Looks at the center of a box from above and at an angle
+     *
+     * @param camera Camera to position
+     * @param minimum Minimum corner of the box
+     * @param maximum Maximum corner of the box
+     */
+    static void frameCamera(Qt3DRender::QCamera* camera, const QVector3D& minimum, const QVector3D& maximum);
+};
+
+#endif // GEO3DSCENEBUILDER_H
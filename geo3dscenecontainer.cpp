@@ -0,0 +1,311 @@
+#include "geo3dscenecontainer.h"
+#include "geo3dobject.h"
+
+#include <QSaveFile>
+#include <QCborValue>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+#include <limits>
+
+static const char s_headerMagic[4] = {'G', '3', 'D', 'C'};
+static const char s_trailerMagic[4] = {'G', '3', 'D', 'I'};
+static const quint32 s_containerVersion = 1;
+
+static const qint64 s_headerSize = 8;
+static const qint64 s_trailerSize = 8 + 4 + 8 + 4 + 4;
+static const qint64 s_entryFixedSize = 8 + 4 + 6 * 4 + 2 + 2;
+
+template <typename T>
+static void appendLittleEndian(QByteArray& buffer, T value)
+{
+    uchar bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    buffer.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+Geo3DSceneContainer::Geo3DSceneContainer()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_layersOffset(0)
+    , m_layersLength(0)
+{
+}
+
+Geo3DSceneContainer::~Geo3DSceneContainer()
+{
+    close();
+}
+
+bool Geo3DSceneContainer::write(const QString& filePath, const QMap<QString, Geo3DObject*>& objects,
+                                const QCborMap& layers)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open file for writing:" << filePath;
+        return false;
+    }
+
+    QByteArray header(s_headerMagic, 4);
+    appendLittleEndian<quint32>(header, s_containerVersion);
+    bool ok = file.write(header) != -1;
+
+    // Records are streamed to the file; only the index is accumulated
+    QByteArray index;
+    quint32 entryCount = 0;
+    qint64 offset = s_headerSize;
+
+    for (auto it = objects.constBegin(); ok && it != objects.constEnd(); ++it) {
+        Geo3DObject* object = it.value();
+        if (!object) {
+            continue;
+        }
+
+        const QByteArray record = QCborValue(object->toCbor()).toCbor();
+        ok = file.write(record) != -1;
+
+        QVector3D boundsMin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::max());
+        QVector3D boundsMax(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+                            -std::numeric_limits<float>::max());
+        object->getBoundingBox(boundsMin, boundsMax);
+
+        const QByteArray name = it.key().toUtf8();
+        const QByteArray type = object->getObjectType().toUtf8();
+        if (name.size() > 0xffff || type.size() > 0xffff) {
+            qWarning() << "Object name too long for scene container:" << it.key();
+            ok = false;
+            break;
+        }
+
+        appendLittleEndian<quint64>(index, quint64(offset));
+        appendLittleEndian<quint32>(index, quint32(record.size()));
+        for (int axis = 0; axis < 3; ++axis) {
+            appendLittleEndian<float>(index, boundsMin[axis]);
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            appendLittleEndian<float>(index, boundsMax[axis]);
+        }
+        appendLittleEndian<quint16>(index, quint16(name.size()));
+        appendLittleEndian<quint16>(index, quint16(type.size()));
+        index.append(name);
+        index.append(type);
+
+        offset += record.size();
+        ++entryCount;
+    }
+
+    const qint64 layersOffset = offset;
+    QByteArray layersRecord;
+    if (!layers.isEmpty()) {
+        layersRecord = QCborValue(layers).toCbor();
+        ok = ok && file.write(layersRecord) != -1;
+        offset += layersRecord.size();
+    }
+
+    QByteArray trailer;
+    appendLittleEndian<quint64>(trailer, quint64(offset));
+    appendLittleEndian<quint32>(trailer, entryCount);
+    appendLittleEndian<quint64>(trailer, quint64(layersOffset));
+    appendLittleEndian<quint32>(trailer, quint32(layersRecord.size()));
+    trailer.append(s_trailerMagic, 4);
+
+    ok = ok && file.write(index) != -1;
+    ok = ok && file.write(trailer) != -1;
+
+    if (!ok || !file.commit()) {
+        qWarning() << "Error writing to file:" << filePath;
+        return false;
+    }
+    return true;
+}
+
+bool Geo3DSceneContainer::isContainer(const QByteArray& header)
+{
+    return header.startsWith(QByteArray(s_headerMagic, 4));
+}
+
+bool Geo3DSceneContainer::open(const QString& filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open file for reading:" << filePath;
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < s_headerSize + s_trailerSize) {
+        qWarning() << "Scene container is truncated:" << filePath;
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        qWarning() << "Could not map scene container:" << filePath << m_file.errorString();
+        close();
+        return false;
+    }
+
+    if (memcmp(m_data, s_headerMagic, 4) != 0
+        || qFromLittleEndian<quint32>(m_data + 4) != s_containerVersion) {
+        qWarning() << "Unsupported scene container:" << filePath;
+        close();
+        return false;
+    }
+
+    const uchar* trailer = m_data + m_size - s_trailerSize;
+    if (memcmp(trailer + s_trailerSize - 4, s_trailerMagic, 4) != 0) {
+        qWarning() << "Scene container index is missing:" << filePath;
+        close();
+        return false;
+    }
+
+    const qint64 indexOffset = qint64(qFromLittleEndian<quint64>(trailer));
+    const quint32 entryCount = qFromLittleEndian<quint32>(trailer + 8);
+    m_layersOffset = qint64(qFromLittleEndian<quint64>(trailer + 12));
+    m_layersLength = qFromLittleEndian<quint32>(trailer + 20);
+
+    const qint64 indexEnd = m_size - s_trailerSize;
+    if (indexOffset < s_headerSize || indexOffset > indexEnd
+        || m_layersOffset < s_headerSize || m_layersOffset + m_layersLength > indexOffset) {
+        qWarning() << "Scene container index is corrupt:" << filePath;
+        close();
+        return false;
+    }
+
+    // Only the index is parsed up front; records stay in the mapping
+    m_entries.reserve(int(entryCount));
+    m_nameIndex.reserve(int(entryCount));
+
+    const uchar* in = m_data + indexOffset;
+    const uchar* end = m_data + indexEnd;
+    for (quint32 i = 0; i < entryCount; ++i) {
+        if (end - in < s_entryFixedSize) {
+            qWarning() << "Scene container index is corrupt:" << filePath;
+            close();
+            return false;
+        }
+
+        Entry entry;
+        entry.offset = qint64(qFromLittleEndian<quint64>(in));
+        entry.length = qFromLittleEndian<quint32>(in + 8);
+        for (int axis = 0; axis < 3; ++axis) {
+            entry.boundsMin[axis] = qFromLittleEndian<float>(in + 12 + axis * 4);
+            entry.boundsMax[axis] = qFromLittleEndian<float>(in + 24 + axis * 4);
+        }
+        const int nameLength = qFromLittleEndian<quint16>(in + 36);
+        const int typeLength = qFromLittleEndian<quint16>(in + 38);
+        in += s_entryFixedSize;
+
+        if (end - in < nameLength + typeLength
+            || entry.offset < s_headerSize || entry.offset + entry.length > indexOffset) {
+            qWarning() << "Scene container index is corrupt:" << filePath;
+            close();
+            return false;
+        }
+
+        entry.name = QString::fromUtf8(reinterpret_cast<const char*>(in), nameLength);
+        in += nameLength;
+        entry.type = QString::fromUtf8(reinterpret_cast<const char*>(in), typeLength);
+        in += typeLength;
+
+        m_nameIndex.insert(entry.name, m_entries.size());
+        m_entries.append(entry);
+    }
+
+    return true;
+}
+
+void Geo3DSceneContainer::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_layersOffset = 0;
+    m_layersLength = 0;
+    m_entries.clear();
+    m_nameIndex.clear();
+}
+
+bool Geo3DSceneContainer::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+int Geo3DSceneContainer::entryCount() const
+{
+    return m_entries.size();
+}
+
+const Geo3DSceneContainer::Entry& Geo3DSceneContainer::entry(int index) const
+{
+    return m_entries.at(index);
+}
+
+int Geo3DSceneContainer::indexOf(const QString& name) const
+{
+    return m_nameIndex.value(name, -1);
+}
+
+QVector<int> Geo3DSceneContainer::findInRegion(const QVector3D& regionMin, const QVector3D& regionMax) const
+{
+    QVector<int> result;
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const Entry& entry = m_entries[i];
+        if (entry.boundsMin.x() <= regionMax.x() && entry.boundsMax.x() >= regionMin.x()
+            && entry.boundsMin.y() <= regionMax.y() && entry.boundsMax.y() >= regionMin.y()
+            && entry.boundsMin.z() <= regionMax.z() && entry.boundsMax.z() >= regionMin.z()) {
+            result.append(i);
+        }
+    }
+    return result;
+}
+
+QVector<int> Geo3DSceneContainer::findByPrefix(const QString& prefix) const
+{
+    QVector<int> result;
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries[i].name.startsWith(prefix)) {
+            result.append(i);
+        }
+    }
+    return result;
+}
+
+Geo3DObject* Geo3DSceneContainer::createObject(int index) const
+{
+    if (!m_data || index < 0 || index >= m_entries.size()) {
+        return nullptr;
+    }
+
+    // Wrap the mapped bytes without copying them into a heap buffer
+    const Entry& entry = m_entries[index];
+    const QByteArray record = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + entry.offset),
+                                                      int(entry.length));
+
+    QCborParserError error;
+    QCborValue value = QCborValue::fromCbor(record, &error);
+    if (error.error != QCborError::NoError || !value.isMap()) {
+        qWarning() << "Corrupt object record in scene container:" << entry.name << error.errorString();
+        return nullptr;
+    }
+
+    return Geo3DObject::createFromCbor(value.toMap());
+}
+
+QCborMap Geo3DSceneContainer::layers() const
+{
+    if (!m_data || m_layersLength == 0) {
+        return QCborMap();
+    }
+
+    const QByteArray record = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + m_layersOffset),
+                                                      int(m_layersLength));
+    return QCborValue::fromCbor(record).toMap();
+}
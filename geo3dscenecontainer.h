@@ -0,0 +1,192 @@
+/**
+ * @file geo3dscenecontainer.h
+ * @brief Header file for the Geo3DSceneContainer class
+ */
+
+#ifndef GEO3DSCENECONTAINER_H
+#define GEO3DSCENECONTAINER_H
+
+#include <QCborMap>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+
+class Geo3DObject;
+
+/**
+ * @class Geo3DSceneContainer
+ * @brief Binary scene file with a footer index for random access to object records
+ *
+ * The container stores every object as an independent CBOR record (the same
+ * encoding as Geo3DObject::toCbor(), so packed arrays such as face vertices
+ * stay packed), followed by an index of fixed-layout entries that give each
+ * record's name, type, byte range and world-space bounding box. A small
+ * trailer at the very end of the file locates the index.
+ *
+ * File layout (all integers little endian):
+ * @code
+ * header   "G3DC" magic, quint32 version
+ * records  CBOR object records, back to back
+ * layers   CBOR map with the layer table (optional)
+ * index    per entry: quint64 offset, quint32 length, 6 x float bounds,
+ *          quint16 name length, quint16 type length, UTF-8 name, UTF-8 type
+ * trailer  quint64 index offset, quint32 entry count,
+ *          quint64 layers offset, quint32 layers length, "G3DI" magic
+ * @endcode
+ *
+ * The reader maps the file into memory and only parses the index when it is
+ * opened. Records are decoded straight out of the mapping when requested, so
+ * loading a subset of a large scene costs time proportional to the subset.
+ *
+ * Example usage:
+ * @code
+ * Geo3DSceneContainer container;
+ * if (container.open("region.g3dc")) {
+ *     for (int index : container.findInRegion(siteMin, siteMax)) {
+ *         Geo3DObject* object = container.createObject(index);
+ *         ...
+ *     }
+ * }
+ * @endcode
+ */
+class Geo3DSceneContainer
+{
+public:
+    /**
+     * @brief Index entry describing one object record
+     */
+    struct Entry
+    {
+        QString name;
+        QString type;
+        qint64 offset = 0;
+        qint64 length = 0;
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+    };
+
+    /**
+     * @brief Default constructor
+     *
+     * Creates a container that is not attached to any file.
+     */
+    explicit Geo3DSceneContainer();
+
+    /**
+     * @brief Destructor
+     *
+     * Unmaps and closes the file.
+     */
+    ~Geo3DSceneContainer();
+
+    Geo3DSceneContainer(const Geo3DSceneContainer&) = delete;
+    Geo3DSceneContainer& operator=(const Geo3DSceneContainer&) = delete;
+
+    /**
+     * @brief Writes objects and layers to a container file
+     *
+     * Objects without a geometric extent get an empty (inverted) bounding box
+     * and are never returned by findInRegion().
+     *
+     * @param filePath Destination path; the file is replaced atomically
+     * @param objects Objects keyed by name
+     * @param layers Layer table in the same form as the "layers" scene member
+     * @return true if the file was written successfully
+     */
+    static bool write(const QString& filePath, const QMap<QString, Geo3DObject*>& objects,
+                      const QCborMap& layers = QCborMap());
+
+    /**
+     * @brief Checks whether a file starts with the container magic
+     *
+     * @param header At least the first four bytes of the file
+     * @return true if the bytes identify a container file
+     */
+    static bool isContainer(const QByteArray& header);
+
+    /**
+     * @brief Maps a container file and reads its index
+     *
+     * @param filePath Path to the container file
+     * @return true if the file is a valid container
+     */
+    bool open(const QString& filePath);
+
+    /**
+     * @brief Unmaps and closes the file
+     */
+    void close();
+
+    /**
+     * @brief Checks whether a file is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the number of object records in the container
+     */
+    int entryCount() const;
+
+    /**
+     * @brief Gets the index entry at a position
+     *
+     * @param index Position in the range [0, entryCount())
+     */
+    const Entry& entry(int index) const;
+
+    /**
+     * @brief Finds the entry for an object name
+     *
+     * @param name Object name
+     * @return Entry position, or -1 if there is no such object
+     */
+    int indexOf(const QString& name) const;
+
+    /**
+     * @brief Finds the entries whose bounding box intersects a region
+     *
+     * @param regionMin Minimum corner of the region in world space
+     * @param regionMax Maximum corner of the region in world space
+     * @return Entry positions in index order
+     */
+    QVector<int> findInRegion(const QVector3D& regionMin, const QVector3D& regionMax) const;
+
+    /**
+     * @brief Finds the entries whose object name starts with a prefix
+     *
+     * @param prefix Name prefix; an empty prefix matches every entry
+     * @return Entry positions in index order
+     */
+    QVector<int> findByPrefix(const QString& prefix) const;
+
+    /**
+     * @brief Decodes one object record from the mapped file
+     *
+     * @param index Entry position
+     * @return New object owned by the caller, or nullptr on error
+     */
+    Geo3DObject* createObject(int index) const;
+
+    /**
+     * @brief Gets the layer table stored with the scene
+     *
+     * @return Layer map, empty if the container has no layers
+     */
+    QCborMap layers() const;
+
+private:
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+
+    qint64 m_layersOffset;
+    qint64 m_layersLength;
+
+    QVector<Entry> m_entries;
+    QHash<QString, int> m_nameIndex;
+};
+
+#endif // GEO3DSCENECONTAINER_H
@@ -0,0 +1,132 @@
+#include "geo3dscenegenerator.h"
+#include "geo3dobjectset.h"
+#include "cylinderobject.h"
+#include "tubeobject.h"
+#include "faceobject.h"
+
+#include <QColor>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QVector2D>
+#include <QtMath>
+
+// Lithology colors; consecutive layers of neighbouring boreholes mostly match
+static const QColor s_lithologyColors[] = {
+    QColor(194, 178, 128),  // Sand
+    QColor(170, 150, 120),  // Silt
+    QColor(140, 110, 90),   // Clay
+    QColor(80, 60, 40),     // Peat
+    QColor(128, 128, 128),  // Gravel
+    QColor(200, 200, 180),  // Limestone
+    QColor(90, 90, 100),    // Shale
+    QColor(110, 80, 70)     // Bedrock
+};
+static const int s_lithologyCount = int(sizeof(s_lithologyColors) / sizeof(s_lithologyColors[0]));
+
+static const int s_defaultObjectsPerHorizon = 10000;
+static const int s_maxDefaultHorizons = 64;
+
+// Vertical distance between horizons in meters
+static const float s_horizonSpacing = 10.0f;
+
+// Uniform value in [0, steps] * step, so dimensions repeat across boreholes
+static float steppedValue(QRandomGenerator& random, int steps, float step)
+{
+    return float(random.bounded(steps + 1)) * step;
+}
+
+Geo3DSceneGenerator::Parameters Geo3DSceneGenerator::parametersForObjectCount(int objectCount, quint32 seed)
+{
+    Parameters parameters;
+    parameters.seed = seed;
+
+    objectCount = qMax(1, objectCount);
+    parameters.horizonCount = qBound(1, objectCount / s_defaultObjectsPerHorizon, s_maxDefaultHorizons);
+    parameters.horizonCount = qMin(parameters.horizonCount, objectCount);
+
+    const int layerObjects = objectCount - parameters.horizonCount;
+    parameters.boreholeCount = layerObjects / parameters.layersPerBorehole;
+    parameters.horizonCount += layerObjects % parameters.layersPerBorehole;
+    return parameters;
+}
+
+int Geo3DSceneGenerator::objectCount(const Parameters& parameters)
+{
+    return qMax(0, parameters.boreholeCount) * qMax(0, parameters.layersPerBorehole)
+        + qMax(0, parameters.horizonCount);
+}
+
+int Geo3DSceneGenerator::generate(Geo3DObjectSet& objectSet, const Parameters& parameters)
+{
+    QRandomGenerator random(parameters.seed);
+    Geo3DObjectSet::EditTransaction edit(objectSet);
+    int added = 0;
+
+    const int columns = qMax(1, int(qCeil(qSqrt(double(qMax(1, parameters.boreholeCount))))));
+    const float spacing = parameters.boreholeSpacing;
+    const float siteSize = columns * spacing;
+
+    // Boreholes: a stack of layers hanging down from a slightly uneven surface
+    for (int borehole = 0; borehole < parameters.boreholeCount; ++borehole) {
+        const float x = (borehole % columns) * spacing + float(random.bounded(0.5) - 0.25) * spacing;
+        const float z = (borehole / columns) * spacing + float(random.bounded(0.5) - 0.25) * spacing;
+        const float radius = 0.5f + steppedValue(random, 3, 0.25f);
+        const int lithologyShift = int(random.bounded(2));
+        float top = -steppedValue(random, 10, 0.5f);
+
+        for (int layer = 0; layer < parameters.layersPerBorehole; ++layer) {
+            const float thickness = 1.0f + steppedValue(random, 18, 0.5f);
+            const bool cased = random.generateDouble() < parameters.casedFraction;
+
+            Geo3DObject* object = nullptr;
+            if (cased) {
+                object = new TubeObject(radius, radius + 0.25f, thickness);
+            } else {
+                object = new CylinderObject(radius, thickness);
+            }
+            object->setPosition(x, top - thickness / 2.0f, z);
+
+            const QColor& color = s_lithologyColors[(layer + lithologyShift) % s_lithologyCount];
+            object->setDiffuseColor(color);
+            object->setAmbientColor(color.darker(150));
+
+            objectSet.addObject(QStringLiteral("borehole_%1_layer_%2")
+                                    .arg(borehole, 6, 10, QLatin1Char('0'))
+                                    .arg(layer, 2, 10, QLatin1Char('0')),
+                                object);
+            ++added;
+            top -= thickness;
+        }
+    }
+
+    // Horizons: lobed outlines around the site center, concave between the lobes
+    const QVector2D center(siteSize / 2.0f, siteSize / 2.0f);
+    const int vertexCount = qMax(3, parameters.horizonVertexCount);
+    for (int horizon = 0; horizon < parameters.horizonCount; ++horizon) {
+        const float baseRadius = siteSize * 0.6f + spacing;
+        const float phase1 = float(random.bounded(2.0 * M_PI));
+        const float phase2 = float(random.bounded(2.0 * M_PI));
+        const int lobes1 = 3 + int(random.bounded(3));
+        const int lobes2 = 7 + int(random.bounded(5));
+
+        QVector<QVector2D> vertices;
+        vertices.reserve(vertexCount);
+        for (int v = 0; v < vertexCount; ++v) {
+            const float angle = 2.0f * float(M_PI) * v / vertexCount;
+            const float shape = 0.6f * qSin(lobes1 * angle + phase1) + 0.4f * qSin(lobes2 * angle + phase2);
+            const float radius = baseRadius * (0.6f + 0.2f * (shape + 1.0f));
+            vertices.append(center + radius * QVector2D(qCos(angle), qSin(angle)));
+        }
+
+        FaceObject* face = new FaceObject(vertices, -(horizon + 1) * s_horizonSpacing);
+        const QColor& color = s_lithologyColors[horizon % s_lithologyCount];
+        face->setDiffuseColor(color);
+        face->setAmbientColor(color.darker(150));
+        face->setOpacity(0.5f);
+
+        objectSet.addObject(QStringLiteral("horizon_%1").arg(horizon, 4, 10, QLatin1Char('0')), face);
+        ++added;
+    }
+
+    return added;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file geo3dscenegenerator.h
+ * @brief Header file for the Geo3DSceneGenerator class
+ */
+
+#ifndef GEO3DSCENEGENERATOR_H
+#define GEO3DSCENEGENERATOR_H
+
+#include <QtGlobal>
+
+class Geo3DObjectSet;
+
+/**
+ * @class Geo3DSceneGenerator
+ * @brief Generates reproducible synthetic site models for stress testing
+ *
+ * A site consists of boreholes on a jittered grid, each made of a stack of
+ * layers, plus large concave horizon outlines spanning the site. Layers are
+ * cylinders, or tubes where the borehole is cased. Layer colors come from a
+ * small lithology palette and dimensions are rounded to realistic steps, so
+ * materials and meshes are shared the way they are in real projects.
+ *
+ * The same parameters and seed always produce the same objects, names and
+ * values, on every platform.
+ *
+ * Object names are "borehole_NNNNNN_layer_NN" and "horizon_NNNN", so
+ * prefix queries can select a single borehole.
+ *
+ * Example usage:
+ * @code
+ * Geo3DObjectSet scene;
+ * Geo3DSceneGenerator::generate(scene, Geo3DSceneGenerator::parametersForObjectCount(100000));
+ * scene.saveToFile("site_100k.g3dc", Geo3DObjectSet::ContainerFormat);
+ * @endcode
+ */
+class Geo3DSceneGenerator
+{
+public:
+    /**
+     * @brief Shape of the generated site
+     */
+    struct Parameters
+    {
+        quint32 seed = 1;
+
+        int boreholeCount = 100;          ///< Boreholes, laid out on a square grid
+        float boreholeSpacing = 25.0f;    ///< Grid spacing in meters
+        int layersPerBorehole = 5;        ///< Layer objects per borehole
+        float casedFraction = 0.3f;       ///< Probability that a layer is a cased tube
+
+        int horizonCount = 4;             ///< Concave horizon outlines
+        int horizonVertexCount = 256;     ///< Vertices per outline
+    };
+
+    /**
+     * @brief Chooses parameters that produce exactly the given number of objects
+     *
+     * Uses the default number of layers per borehole and one horizon per
+     * 10000 objects (at least one, at most 64). Objects that do not fill a
+     * whole borehole become additional horizons.
+     *
+     * @param objectCount Total number of objects to generate
+     * @param seed Seed of the random generator
+     * @return Parameters for generate()
+     */
+    static Parameters parametersForObjectCount(int objectCount, quint32 seed = 1);
+
+    /**
+     * @brief Gets the number of objects generate() adds for a set of parameters
+     *
+     * @param parameters Site parameters
+     * @return Number of objects
+     */
+    static int objectCount(const Parameters& parameters);
+
+    /**
+     * @brief Adds a generated site to an object set
+     *
+     * Objects are added inside one edit transaction.
+     *
+     * @param objectSet Set that receives the objects
+     * @param parameters Site parameters
+     * @return Number of objects added
+     */
+    static int generate(Geo3DObjectSet& objectSet, const Parameters& parameters);
+};
+
+#endif // GEO3DSCENEGENERATOR_H
@@ -0,0 +1,267 @@
+#include "geo3dtessellationcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+static const char s_magic[4] = {'G', '3', 'D', 'T'};
+
+// Bump whenever a generateMesh() implementation changes its output, so stale meshes are not reused
+static const quint32 s_cacheVersion = 2;
+
+static const char s_fileSuffix[] = ".mesh";
+
+// Header: magic, version, flags, vertex count, index count, shape key length
+static const int s_headerSize = 4 + 5 * 4;
+static const quint32 s_normalsFlag = 0x1;
+
+Geo3DTessellationCache::Geo3DTessellationCache(const QString& directory, qint64 maximumSize)
+    : m_directory(directory)
+    , m_maximumSize(maximumSize)
+    , m_totalSize(0)
+{
+    QDir dir(m_directory);
+    if (!dir.mkpath(QStringLiteral("."))) {
+        qWarning() << "Could not create tessellation cache directory:" << m_directory;
+        return;
+    }
+
+    const QFileInfoList files = dir.entryInfoList(QStringList() << QStringLiteral("*") + QLatin1String(s_fileSuffix),
+                                                  QDir::Files);
+    m_entries.reserve(files.size());
+    for (const QFileInfo& info : files) {
+        Entry entry;
+        entry.size = info.size();
+        entry.lastUsed = info.lastModified().toMSecsSinceEpoch();
+        m_entries.insert(info.completeBaseName().toLatin1(), entry);
+        m_totalSize += entry.size;
+    }
+
+    // The limit may have been lowered since the files were written
+    evict(0);
+}
+
+QString Geo3DTessellationCache::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/tessellation");
+}
+
+QByteArray Geo3DTessellationCache::contentHash(const QByteArray& shapeKey)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(reinterpret_cast<const char*>(&s_cacheVersion), sizeof(s_cacheVersion));
+    hash.addData(shapeKey);
+    return hash.result().toHex();
+}
+
+bool Geo3DTessellationCache::lookup(const QByteArray& shapeKey, Geo3DObject::MeshData& mesh)
+{
+    QMutexLocker locker(&m_mutex);
+    const QByteArray hash = contentHash(shapeKey);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) {
+        ++m_statistics.misses;
+        return false;
+    }
+
+    QFile file(filePath(hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        removeEntry(hash);
+        ++m_statistics.misses;
+        return false;
+    }
+
+    // Read straight into the mesh buffers; the file is small and read once
+    const qint64 size = file.size();
+    char magic[4] = {};
+    quint32 header[5] = {};
+    bool valid = size >= s_headerSize
+        && file.read(magic, 4) == 4 && memcmp(magic, s_magic, 4) == 0
+        && file.read(reinterpret_cast<char*>(header), sizeof(header)) == qint64(sizeof(header))
+        && header[0] == s_cacheVersion;
+
+    const bool hasNormals = header[1] & s_normalsFlag;
+    const qint64 vertexBytes = qint64(header[2]) * (hasNormals ? 6 : 3) * qint64(sizeof(float));
+    const qint64 indexBytes = qint64(header[3]) * qint64(sizeof(quint32));
+    const qint64 keyBytes = header[4];
+    valid = valid && s_headerSize + keyBytes + vertexBytes + indexBytes == size
+        && keyBytes == shapeKey.size()
+        && file.read(keyBytes) == shapeKey;
+
+    QByteArray vertices;
+    QByteArray indices;
+    if (valid) {
+        vertices = QByteArray(qsizetype(vertexBytes), Qt::Uninitialized);
+        indices = QByteArray(qsizetype(indexBytes), Qt::Uninitialized);
+        valid = file.read(vertices.data(), vertexBytes) == vertexBytes
+            && file.read(indices.data(), indexBytes) == indexBytes;
+    }
+
+    if (!valid) {
+        file.close();
+        qWarning() << "Discarding corrupt tessellation cache file:" << file.fileName();
+        QFile::remove(file.fileName());
+        removeEntry(hash);
+        ++m_statistics.misses;
+        return false;
+    }
+
+    mesh.vertices = vertices;
+    mesh.indices = indices;
+    mesh.vertexCount = int(header[2]);
+    mesh.indexCount = int(header[3]);
+    mesh.hasNormals = hasNormals;
+
+    // The modification time records the last use for eviction across restarts
+    const QDateTime now = QDateTime::currentDateTime();
+    file.setFileTime(now, QFileDevice::FileModificationTime);
+    it->lastUsed = now.toMSecsSinceEpoch();
+
+    ++m_statistics.hits;
+    m_statistics.bytesRead += size;
+    return true;
+}
+
+bool Geo3DTessellationCache::store(const QByteArray& shapeKey, const Geo3DObject::MeshData& mesh)
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 size = s_headerSize + shapeKey.size() + mesh.vertices.size() + mesh.indices.size();
+    if (size > m_maximumSize) {
+        return false;
+    }
+
+    const QByteArray hash = contentHash(shapeKey);
+    removeEntry(hash);
+    evict(size);
+
+    QSaveFile file(filePath(hash));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write tessellation cache file:" << file.fileName();
+        return false;
+    }
+
+    const quint32 header[5] = {
+        s_cacheVersion,
+        mesh.hasNormals ? s_normalsFlag : 0u,
+        quint32(mesh.vertexCount),
+        quint32(mesh.indexCount),
+        quint32(shapeKey.size())
+    };
+
+    bool ok = file.write(s_magic, 4) == 4;
+    ok = ok && file.write(reinterpret_cast<const char*>(header), sizeof(header)) == qint64(sizeof(header));
+    ok = ok && file.write(shapeKey) == shapeKey.size();
+    ok = ok && file.write(mesh.vertices) == mesh.vertices.size();
+    ok = ok && file.write(mesh.indices) == mesh.indices.size();
+    if (!ok || !file.commit()) {
+        qWarning() << "Error writing tessellation cache file:" << file.fileName();
+        return false;
+    }
+
+    Entry entry;
+    entry.size = size;
+    entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    m_entries.insert(hash, entry);
+    m_totalSize += size;
+
+    ++m_statistics.stores;
+    m_statistics.bytesWritten += size;
+    return true;
+}
+
+void Geo3DTessellationCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        QFile::remove(filePath(it.key()));
+    }
+    m_entries.clear();
+    m_totalSize = 0;
+}
+
+QString Geo3DTessellationCache::getDirectory() const
+{
+    return m_directory;
+}
+
+void Geo3DTessellationCache::setMaximumSize(qint64 maximumSize)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maximumSize = maximumSize;
+    evict(0);
+}
+
+qint64 Geo3DTessellationCache::getMaximumSize() const
+{
+    return m_maximumSize;
+}
+
+qint64 Geo3DTessellationCache::totalSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_totalSize;
+}
+
+int Geo3DTessellationCache::entryCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+Geo3DTessellationCache::Statistics Geo3DTessellationCache::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+void Geo3DTessellationCache::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+    m_statistics = Statistics();
+}
+
+QString Geo3DTessellationCache::filePath(const QByteArray& hash) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(hash) + QLatin1String(s_fileSuffix);
+}
+
+void Geo3DTessellationCache::evict(qint64 incomingSize)
+{
+    if (m_totalSize + incomingSize <= m_maximumSize) {
+        return;
+    }
+
+    // Oldest first
+    QVector<QPair<qint64, QByteArray>> byAge;
+    byAge.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        byAge.append(qMakePair(it->lastUsed, it.key()));
+    }
+    std::sort(byAge.begin(), byAge.end());
+
+    for (const auto& candidate : std::as_const(byAge)) {
+        if (m_totalSize + incomingSize <= m_maximumSize) {
+            break;
+        }
+        QFile::remove(filePath(candidate.second));
+        removeEntry(candidate.second);
+        ++m_statistics.evictions;
+    }
+}
+
+void Geo3DTessellationCache::removeEntry(const QByteArray& hash)
+{
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end()) {
+        m_totalSize -= it->size;
+        m_entries.erase(it);
+    }
+}
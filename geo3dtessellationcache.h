@@ -0,0 +1,170 @@
+/**
+ * @file geo3dtessellationcache.h
+ * @brief Header file for the Geo3DTessellationCache class
+ */
+
+#ifndef GEO3DTESSELLATIONCACHE_H
+#define GEO3DTESSELLATIONCACHE_H
+
+#include "geo3dobject.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @class Geo3DTessellationCache
+ * @brief Persistent on-disk cache of generated meshes
+ *
+ * Meshes produced by Geo3DObject::generateMesh() are stored in one file per
+ * shape, named after a SHA-1 content hash of the object's shape key (which
+ * covers the shape parameters and tessellation settings). On the next start
+ * the buffers are read from the file straight into the mesh instead of
+ * tessellating the shape again.
+ *
+ * The total size of the cache directory is bounded. When a new mesh would
+ * exceed the limit, the least recently used files are evicted; the
+ * modification time of a file records its last use, so the order survives
+ * restarts.
+ *
+ * Lookups and stores may be called from several threads at once, e.g.
+ * while meshes are generated in the background.
+ *
+ * Buffers are stored in native byte order, so a cache directory is only
+ * meant to be reused on the machine that wrote it. Files with an unexpected
+ * header or a mismatching shape key are treated as misses.
+ *
+ * Example usage:
+ * @code
+ * Geo3DTessellationCache cache(Geo3DTessellationCache::defaultDirectory());
+ * objectSet.setTessellationCache(&cache);
+ * objectSet.createEntities(rootEntity);
+ * qDebug() << cache.statistics().hits << "meshes loaded from the cache";
+ * @endcode
+ */
+class Geo3DTessellationCache
+{
+public:
+    /**
+     * @brief Default size limit of the cache directory (256 MiB)
+     */
+    static const qint64 DefaultMaximumSize = 256 * 1024 * 1024;
+
+    /**
+     * @brief Counters since construction or the last resetStatistics()
+     */
+    struct Statistics
+    {
+        int hits = 0;
+        int misses = 0;
+        int stores = 0;
+        int evictions = 0;
+        qint64 bytesRead = 0;
+        qint64 bytesWritten = 0;
+    };
+
+    /**
+     * @brief Opens a cache directory, creating it if necessary
+     *
+     * The directory is scanned once to learn the size and last use of the
+     * existing files.
+     *
+     * @param directory Directory holding the cache files
+     * @param maximumSize Size limit in bytes
+     */
+    explicit Geo3DTessellationCache(const QString& directory = defaultDirectory(),
+                                    qint64 maximumSize = DefaultMaximumSize);
+
+    /**
+     * @brief Gets the per-user cache location used when no directory is given
+     *
+     * @return "tessellation" below QStandardPaths::CacheLocation
+     */
+    static QString defaultDirectory();
+
+    /**
+     * @brief Computes the content hash that names the file of a shape
+     *
+     * @param shapeKey Key from Geo3DObject::getShapeKey()
+     * @return Hex-encoded SHA-1 over the cache format version and the key
+     */
+    static QByteArray contentHash(const QByteArray& shapeKey);
+
+    /**
+     * @brief Loads a cached mesh
+     *
+     * @param shapeKey Key from Geo3DObject::getShapeKey()
+     * @param mesh Receives the buffers on a hit
+     * @return true if a valid mesh for the key was found
+     */
+    bool lookup(const QByteArray& shapeKey, Geo3DObject::MeshData& mesh);
+
+    /**
+     * @brief Stores a mesh, evicting least recently used files if needed
+     *
+     * Meshes larger than the size limit are not stored.
+     *
+     * @param shapeKey Key from Geo3DObject::getShapeKey()
+     * @param mesh Buffers to store
+     * @return true if the file was written
+     */
+    bool store(const QByteArray& shapeKey, const Geo3DObject::MeshData& mesh);
+
+    /**
+     * @brief Removes every cache file
+     */
+    void clear();
+
+    QString getDirectory() const;
+
+    /**
+     * @brief Sets the size limit and evicts files until it is respected
+     *
+     * @param maximumSize Size limit in bytes
+     */
+    void setMaximumSize(qint64 maximumSize);
+    qint64 getMaximumSize() const;
+
+    /**
+     * @brief Gets the total size of the cache files
+     *
+     * @return Size in bytes
+     */
+    qint64 totalSize() const;
+
+    /**
+     * @brief Gets the number of cached meshes
+     *
+     * @return Number of cache files
+     */
+    int entryCount() const;
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct Entry
+    {
+        qint64 size = 0;
+        qint64 lastUsed = 0;
+    };
+
+    QString filePath(const QByteArray& hash) const;
+
+    // Removes least recently used files until the given number of bytes fits
+    void evict(qint64 incomingSize);
+
+    void removeEntry(const QByteArray& hash);
+
+    QString m_directory;
+    qint64 m_maximumSize;
+    qint64 m_totalSize;
+    QHash<QByteArray, Entry> m_entries;
+    Statistics m_statistics;
+
+    // Guards the entries, the statistics and the files of the directory
+    mutable QMutex m_mutex;
+};
+
+#endif // GEO3DTESSELLATIONCACHE_H
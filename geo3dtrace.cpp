@@ -0,0 +1,176 @@
+#include "geo3dtrace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QVector>
+#include <QDebug>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct TraceEvent
+{
+    const char* category;
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+};
+
+// Events of one thread; the lock is only contended while the trace is written
+struct TraceThreadBuffer
+{
+    int threadId = 0;
+    QString threadName;
+    QMutex mutex;
+    QVector<TraceEvent> events;
+};
+
+struct TraceState
+{
+    std::atomic<bool> enabled{false};
+    QElapsedTimer clock;
+
+    QMutex mutex;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> buffers;
+};
+
+static TraceState& traceState()
+{
+    static TraceState state;
+    return state;
+}
+
+// Buffer of the calling thread, registered on first use
+static TraceThreadBuffer* threadBuffer()
+{
+    thread_local TraceThreadBuffer* buffer = nullptr;
+    if (buffer) {
+        return buffer;
+    }
+
+    TraceState& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    state.buffers.push_back(std::make_unique<TraceThreadBuffer>());
+    buffer = state.buffers.back().get();
+    buffer->threadId = int(state.buffers.size());
+
+    QThread* thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+        buffer->threadName = QStringLiteral("Main thread");
+    } else if (!thread->objectName().isEmpty()) {
+        buffer->threadName = QStringLiteral("%1 %2").arg(thread->objectName()).arg(buffer->threadId);
+    } else {
+        buffer->threadName = QStringLiteral("Thread %1").arg(buffer->threadId);
+    }
+    return buffer;
+}
+
+Geo3DTrace::Scope::Scope(const char* category, const char* name)
+    : m_category(category)
+    , m_name(name)
+    , m_startNs(-1)
+{
+    TraceState& state = traceState();
+    if (state.enabled.load(std::memory_order_relaxed)) {
+        m_startNs = state.clock.nsecsElapsed();
+    }
+}
+
+Geo3DTrace::Scope::~Scope()
+{
+    if (m_startNs < 0) {
+        return;
+    }
+
+    const qint64 endNs = traceState().clock.nsecsElapsed();
+    TraceThreadBuffer* buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    buffer->events.append(TraceEvent{m_category, m_name, m_startNs, endNs - m_startNs});
+}
+
+void Geo3DTrace::setEnabled(bool enabled)
+{
+    TraceState& state = traceState();
+    if (enabled && !state.clock.isValid()) {
+        state.clock.start();
+    }
+    state.enabled.store(enabled);
+}
+
+bool Geo3DTrace::isEnabled()
+{
+    return traceState().enabled.load();
+}
+
+void Geo3DTrace::clear()
+{
+    TraceState& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    for (const std::unique_ptr<TraceThreadBuffer>& buffer : state.buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        buffer->events.clear();
+    }
+}
+
+QJsonObject Geo3DTrace::toJson()
+{
+    const qint64 processId = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    TraceState& state = traceState();
+    QMutexLocker locker(&state.mutex);
+    for (const std::unique_ptr<TraceThreadBuffer>& buffer : state.buffers) {
+        QMutexLocker bufferLocker(&buffer->mutex);
+        if (buffer->events.isEmpty()) {
+            continue;
+        }
+
+        // Lane label for the thread
+        QJsonObject metadata;
+        metadata["ph"] = "M";
+        metadata["name"] = "thread_name";
+        metadata["pid"] = processId;
+        metadata["tid"] = buffer->threadId;
+        metadata["args"] = QJsonObject{{"name", buffer->threadName}};
+        traceEvents.append(metadata);
+
+        // Complete events; timestamps are in microseconds
+        for (const TraceEvent& event : std::as_const(buffer->events)) {
+            QJsonObject json;
+            json["ph"] = "X";
+            json["cat"] = QString::fromLatin1(event.category);
+            json["name"] = QString::fromLatin1(event.name);
+            json["pid"] = processId;
+            json["tid"] = buffer->threadId;
+            json["ts"] = event.startNs / 1000.0;
+            json["dur"] = event.durationNs / 1000.0;
+            traceEvents.append(json);
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    return root;
+}
+
+bool Geo3DTrace::writeToFile(const QString& filePath)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not open file for writing:" << filePath;
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Error writing to file:" << filePath;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file geo3dtrace.h
+ * @brief Header file for the Geo3DTrace class and the GEO3D_TRACE_SCOPE macro
+ */
+
+#ifndef GEO3DTRACE_H
+#define GEO3DTRACE_H
+
+#include <QString>
+#include <QJsonObject>
+
+/**
+ * @class Geo3DTrace
+ * @brief Collects timed scopes and writes them as Chrome trace-event JSON
+ *
+ * The output opens in Perfetto (ui.perfetto.dev) or chrome://tracing. Every
+ * thread that records a scope gets its own lane, so work spread over the
+ * thread pool shows up side by side.
+ *
+ * Instrumentation uses GEO3D_TRACE_SCOPE(), which compiles to nothing unless
+ * GEO3D_TRACE is defined (CONFIG += geo3d_trace in qmake). Even when compiled
+ * in, scopes only record while tracing is enabled at run time.
+ *
+ * Each thread appends to its own buffer, so recording does not contend
+ * between threads.
+ *
+ * Example usage:
+ * @code
+ * Geo3DTrace::setEnabled(true);
+ * {
+ *     GEO3D_TRACE_SCOPE("load", "loadFromFile");
+ *     objectSet.loadFromFile(path);
+ * }
+ * Geo3DTrace::writeToFile("load.trace.json");
+ * @endcode
+ */
+class Geo3DTrace
+{
+public:
+    /**
+     * @brief Records the duration of the enclosing block
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief Starts the scope
+         *
+         * @param category Event category, e.g. "load" (must outlive the trace, use literals)
+         * @param name Event name (must outlive the trace, use literals)
+         */
+        Scope(const char* category, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* m_category;
+        const char* m_name;
+        qint64 m_startNs;
+    };
+
+    /**
+     * @brief Starts or stops recording
+     *
+     * Events recorded so far are kept; clear() discards them.
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * @brief Discards all recorded events
+     */
+    static void clear();
+
+    /**
+     * @brief Converts the recorded events to a Chrome trace document
+     *
+     * @return Object with "traceEvents", including thread-name metadata
+     */
+    static QJsonObject toJson();
+
+    /**
+     * @brief Writes the recorded events to a file
+     *
+     * @param filePath Path to the output file
+     * @return true if the file was written
+     */
+    static bool writeToFile(const QString& filePath);
+};
+
+#ifdef GEO3D_TRACE
+#define GEO3D_TRACE_CONCAT_IMPL(a, b) a##b
+#define GEO3D_TRACE_CONCAT(a, b) GEO3D_TRACE_CONCAT_IMPL(a, b)
+#define GEO3D_TRACE_SCOPE(category, name) \
+    Geo3DTrace::Scope GEO3D_TRACE_CONCAT(geo3dTraceScope, __LINE__)(category, name)
+#else
+#define GEO3D_TRACE_SCOPE(category, name) static_cast<void>(0)
+#endif
+
+#endif // GEO3DTRACE_H
@@ -1,17 +1,50 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QDebug>
 #include "qt3dviewer.h"
 #include "geo3dobjectset.h"
 #include "cylinderobject.h"
 #include "tubeobject.h"
+#include "geo3dtrace.h"
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
+#ifdef GEO3D_TRACE
+    // GEO3D_TRACE_FILE=trace.json records load and render setup for Perfetto
+    const QString traceFile = qEnvironmentVariable("GEO3D_TRACE_FILE");
+    if (!traceFile.isEmpty()) {
+        Geo3DTrace::setEnabled(true);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [traceFile]() {
+            if (Geo3DTrace::writeToFile(traceFile)) {
+                qDebug() << "Trace written to" << traceFile;
+            }
+        });
+    }
+#endif
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Qt3D object set viewer");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scene", "Scene file to open in the 3D view (optional).", "[scene]");
+    parser.process(app);
+
+    // A scene file on the command line skips the demo and opens the 3D view right away
+    const QStringList arguments = parser.positionalArguments();
+    if (!arguments.isEmpty()) {
+        Qt3DViewer viewer;
+        if (!viewer.openSceneFile(arguments.first())) {
+            return 1;
+        }
+        viewer.show();
+        return app.exec();
+    }
+
     qDebug() << "=== Creating Cylinder and Tube Scene ===";
 
-    Geo3DObjectSet* scene = new Geo3DObjectSet();
+    // Declared before the viewer, which releases its entities first
+    Geo3DObjectSet scene;
 
     // Create upper grey cylinder
     // Top elevation = 0, Bottom elevation = -7
@@ -21,7 +54,7 @@ int main(int argc, char *argv[])
     upperCylinder->setDiffuseColor(QColor(128, 128, 128));  // Grey
     upperCylinder->setAmbientColor(QColor(64, 64, 64));     // Darker grey
     upperCylinder->setOpacity(0.5f);
-    scene->addObject("upperCylinder", upperCylinder);
+    scene.addObject("upperCylinder", upperCylinder);
 
     qDebug() << "Created upper grey cylinder:";
     qDebug() << "  - Radius: 1.0m";
@@ -37,7 +70,7 @@ int main(int argc, char *argv[])
     lowerCylinder->setDiffuseColor(QColor(100, 100, 120));  // Slightly bluish grey
     lowerCylinder->setAmbientColor(QColor(50, 50, 60));     // Darker bluish grey
     lowerCylinder->setOpacity(0.5f);
-    scene->addObject("lowerCylinder", lowerCylinder);
+    scene.addObject("lowerCylinder", lowerCylinder);
 
     qDebug() << "Created lower cylinder:";
     qDebug() << "  - Radius: 1.0m";
@@ -53,7 +86,7 @@ int main(int argc, char *argv[])
     upperTube->setAmbientColor(QColor(90, 60, 30));    // Darker brown
     upperTube->setOpacity(0.2f);
     upperTube->setTessellation(20, 48);  // Good quality for large tube
-    scene->addObject("upperTube", upperTube);
+    scene.addObject("upperTube", upperTube);
 
     qDebug() << "Created upper soil tube:";
     qDebug() << "  - Inner radius: 1.0m";
@@ -71,7 +104,7 @@ int main(int argc, char *argv[])
     lowerSoil->setAmbientColor(QColor(80, 50, 30));    // Darker reddish brown
     lowerSoil->setOpacity(0.2f);  // Transparent so you can see the inner cylinder
     lowerSoil->setTessellation(20, 48);  // Good quality
-    scene->addObject("lowerSoil", lowerSoil);
+    scene.addObject("lowerSoil", lowerSoil);
 
     qDebug() << "Created lower soil cylinder:";
     qDebug() << "  - Radius: 12.0m (full cylinder)";
@@ -82,13 +115,16 @@ int main(int argc, char *argv[])
     // Save scene to file
     qDebug() << "\n=== Saving Scene to File ===";
     QString fileName = "cylinder_tube_scene.json";
-    bool saveSuccess = scene->saveToFile(fileName);
+    bool saveSuccess = scene.saveToFile(fileName);
     qDebug() << "Save to file" << fileName << ":" << (saveSuccess ? "SUCCESS" : "FAILED");
 
     // Create viewer and display
     qDebug() << "\n=== Opening 3D Viewer ===";
     Qt3DViewer viewer;
-    viewer.setObjectSet(scene);
+    viewer.setObjectSet(&scene);
+    if (saveSuccess) {
+        viewer.watchSceneFile(fileName);
+    }
     viewer.show();
 
     qDebug() << "\nScene ready! Click 'Show 3D Objects' to visualize.";
@@ -1,47 +1,221 @@
 #include "qt3dviewer.h"
 #include "geo3dobjectset.h"
+#include "geo3dtessellationcache.h"
+#include "geo3dentitypool.h"
+#include "geo3dscenebuilder.h"
+#include "geo3dcamerapath.h"
+#include "geo3dperformancemonitor.h"
+#include "geo3dprogressiveloader.h"
+#include "geo3dtrace.h"
 #include "cylinderobject.h"
-#include "tubeobject.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QLabel>
+#include <QFileSystemWatcher>
+#include <QFileInfo>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QJsonDocument>
+#include <QMessageBox>
 
 #include <Qt3DExtras/QOrbitCameraController>
 #include <Qt3DExtras/Qt3DWindow>
 #include <Qt3DCore/QEntity>
-#include <Qt3DCore/QTransform>
 #include <Qt3DRender/QCamera>
-#include <Qt3DRender/QPointLight>
+#include <Qt3DRender/QRenderSurfaceSelector>
+#include <Qt3DRender/QFrustumCulling>
+#include <Qt3DRender/QLayerFilter>
+#include <Qt3DRender/QRenderCapture>
 #include <QGuiApplication>
-#include <Qt3DExtras/QForwardRenderer>
+#include <QEvent>
 
-Qt3DViewer::Qt3DViewer(QWidget* parent) : QWidget(parent), m_objectSet(nullptr)
+// Writers often truncate and rewrite in several steps; wait for them to settle
+static const int s_reloadDelayMs = 200;
+
+// Idle entity bundles built with each scene, ready for objects that are added or shown later
+static const int s_entityPoolReserve = 256;
+
+static QString formatBytes(qint64 bytes)
+{
+    return QStringLiteral("%1 KiB").arg(bytes / 1024.0, 0, 'f', 1);
+}
+
+// One line per object type, then the Qt3D node counts
+static QString formatMemoryReport(const Geo3DObjectSet::MemoryReport& report)
+{
+    QStringList lines;
+    lines << QStringLiteral("Total: %1").arg(formatBytes(report.totalBytes()));
+    for (auto it = report.types.constBegin(); it != report.types.constEnd(); ++it) {
+        lines << QStringLiteral("%1: %2 objects, %3 parameters, %4 vertex arrays, %5 meshes in %6")
+                     .arg(it.key())
+                     .arg(it->objects)
+                     .arg(formatBytes(it->parameterBytes), formatBytes(it->vertexArrayBytes))
+                     .arg(it->meshes)
+                     .arg(formatBytes(it->meshBufferBytes));
+    }
+    lines << QString();
+    lines << QStringLiteral("Qt3D nodes: %1").arg(report.nodeCount());
+    for (auto it = report.nodeCounts.constBegin(); it != report.nodeCounts.constEnd(); ++it) {
+        lines << QStringLiteral("  %1: %2").arg(it.key()).arg(it.value());
+    }
+    return lines.join(QLatin1Char('\n'));
+}
+
+Qt3DViewer::Qt3DViewer(QWidget* parent)
+    : QWidget(parent)
+    , m_objectSet(nullptr)
+    , m_ownsObjectSet(false)
+    , m_fileWatcher(new QFileSystemWatcher(this))
+    , m_reloadTimer(new QTimer(this))
+    , m_tessellationCache(new Geo3DTessellationCache())
+    , m_entityPool(new Geo3DEntityPool())
+    , m_recordButton(nullptr)
+    , m_performanceButton(nullptr)
+    , m_performanceLabel(nullptr)
+    , m_view(nullptr)
+    , m_layerFilter(nullptr)
+    , m_sceneRoot(nullptr)
 {
+    m_startupTimer.start();
+
     setWindowTitle("Qt3D Object Set Viewer");
     setMinimumSize(800, 600);
     setupUI();
+
+    m_reloadTimer->setSingleShot(true);
+    m_reloadTimer->setInterval(s_reloadDelayMs);
+    connect(m_reloadTimer, &QTimer::timeout, this, &Qt3DViewer::reloadSceneFile);
+    connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this, &Qt3DViewer::onSceneFileChanged);
+}
+
+Qt3DViewer::~Qt3DViewer()
+{
+    // The scene goes before the window that renders it and the set that fills it
+    releaseScene();
+    if (m_objectSet && m_objectSet->getTessellationCache() == m_tessellationCache) {
+        m_objectSet->setTessellationCache(nullptr);
+    }
+    if (m_objectSet && m_objectSet->getEntityPool() == m_entityPool) {
+        m_objectSet->setEntityPool(nullptr);
+    }
+    delete m_view;
+    if (m_ownsObjectSet) {
+        delete m_objectSet;
+    }
+    delete m_entityPool;
+    delete m_tessellationCache;
 }
 
 void Qt3DViewer::setObjectSet(Geo3DObjectSet* objectSet)
 {
+    if (objectSet == m_objectSet) {
+        return;
+    }
+
+    // The displayed entities belong to the old set
+    releaseScene();
+    if (m_view) {
+        m_view->hide();
+    }
+    if (m_objectSet && m_objectSet->getTessellationCache() == m_tessellationCache) {
+        m_objectSet->setTessellationCache(nullptr);
+    }
+    if (m_objectSet && m_objectSet->getEntityPool() == m_entityPool) {
+        m_objectSet->setEntityPool(nullptr);
+    }
+    if (m_ownsObjectSet) {
+        delete m_objectSet;
+        m_ownsObjectSet = false;
+    }
     m_objectSet = objectSet;
 }
 
+bool Qt3DViewer::openSceneFile(const QString& filePath)
+{
+    GEO3D_TRACE_SCOPE("viewer", "openSceneFile");
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    Geo3DObjectSet* objectSet = new Geo3DObjectSet();
+    if (!objectSet->loadFromFile(filePath)) {
+        delete objectSet;
+        return false;
+    }
+    qDebug() << "Loaded" << objectSet->count() << "objects from" << filePath << "in" << loadTimer.elapsed() << "ms";
+
+    setObjectSet(objectSet);
+    m_ownsObjectSet = true;
+    watchSceneFile(filePath);
+    showObjects();
+    return true;
+}
+
 Geo3DObjectSet* Qt3DViewer::getObjectSet() const
 {
     return m_objectSet;
 }
 
+void Qt3DViewer::watchSceneFile(const QString& filePath)
+{
+    if (!m_sceneFilePath.isEmpty()) {
+        m_fileWatcher->removePath(m_sceneFilePath);
+    }
+
+    m_sceneFilePath = QFileInfo(filePath).absoluteFilePath();
+    if (!m_fileWatcher->addPath(m_sceneFilePath)) {
+        qWarning() << "Could not watch scene file:" << m_sceneFilePath;
+    }
+}
+
+void Qt3DViewer::onSceneFileChanged(const QString& filePath)
+{
+    // Saving through QSaveFile replaces the file, which drops it from the watcher
+    if (!m_fileWatcher->files().contains(filePath) && QFileInfo::exists(filePath)) {
+        m_fileWatcher->addPath(filePath);
+    }
+    m_reloadTimer->start();
+}
+
+void Qt3DViewer::reloadSceneFile()
+{
+    if (!m_objectSet || m_sceneFilePath.isEmpty()) {
+        return;
+    }
+
+    // The file may have been replaced between the notification and now
+    if (!m_fileWatcher->files().contains(m_sceneFilePath)) {
+        if (!QFileInfo::exists(m_sceneFilePath)) {
+            return;
+        }
+        m_fileWatcher->addPath(m_sceneFilePath);
+    }
+
+    // Reloading edits the set, which must not happen under a running loader
+    if (m_loader) {
+        m_loader->finishNow();
+    }
+
+    Geo3DObjectSet::ReloadSummary summary;
+    if (!m_objectSet->reloadFromFile(m_sceneFilePath, &summary)) {
+        qWarning() << "Reload failed, keeping the current scene:" << m_sceneFilePath;
+        return;
+    }
+
+    qInfo() << "Reloaded" << m_sceneFilePath << "- added:" << summary.added
+            << "removed:" << summary.removed << "modified:" << summary.modified
+            << "unchanged:" << summary.unchanged << "layers changed:" << summary.layersChanged;
+}
+
 void Qt3DViewer::showObjects()
 {
-    // Create Qt3D window
-    Qt3DExtras::Qt3DWindow *view = new Qt3DExtras::Qt3DWindow();
-    view->defaultFrameGraph()->setClearColor(QColor(QRgb(0x4d4d4f)));
+    GEO3D_TRACE_SCOPE("viewer", "showObjects");
 
-    // Root entity
-    Qt3DCore::QEntity *rootEntity = new Qt3DCore::QEntity();
+    // The window is reused; only the scene under it is rebuilt
+    Qt3DExtras::Qt3DWindow *view = ensureView();
+    releaseScene();
 
     // If no object set is provided, create a default demonstration with cylinders
     if (!m_objectSet || m_objectSet->isEmpty()) {
@@ -69,57 +243,243 @@ void Qt3DViewer::showObjects()
         cylinder3->setDiffuseColor(QColor(200, 50, 50));  // Red
         demoSet->addObject("cylinder3", cylinder3);
 
-        // Create entities for demo objects
-        demoSet->createEntities(rootEntity);
-        m_objectSet = demoSet;  // Use demo set for camera calculation
-    } else {
-        // Use the provided object set
-        m_objectSet->createEntities(rootEntity);
+        // Use demo set for camera calculation; the viewer owns it
+        setObjectSet(demoSet);
+        m_ownsObjectSet = true;
     }
 
-    // Calculate scene bounds and center
-    QVector3D minBound, maxBound, center;
-    calculateSceneBounds(minBound, maxBound, center);
-
-    // Calculate scene size
-    QVector3D sceneSize = maxBound - minBound;
-    float maxDimension = qMax(qMax(sceneSize.x(), sceneSize.y()), sceneSize.z());
-
-    // Calculate camera distance (with some margin)
-    float cameraDistance = maxDimension * 1.5f;
-
-    // Camera setup with automatic positioning
-    Qt3DRender::QCamera *cameraEntity = view->camera();
-    cameraEntity->lens()->setPerspectiveProjection(45.0f, 16.0f/9.0f, 0.1f, cameraDistance * 10.0f);
-
-    // Position camera to look at the scene center from an angle
-    QVector3D cameraPos = center + QVector3D(cameraDistance * 0.7f, cameraDistance * 0.5f, cameraDistance * 0.7f);
-    cameraEntity->setPosition(cameraPos);
-    cameraEntity->setUpVector(QVector3D(0, 1, 0));
-    cameraEntity->setViewCenter(center);
-
+    // Bounding-box proxies first; full meshes replace them as they are tessellated,
+    // reusing meshes from earlier runs
+    QElapsedTimer openTimer;
+    openTimer.start();
+    m_tessellationCache->resetStatistics();
+    m_objectSet->setTessellationCache(m_tessellationCache);
+    Qt3DCore::QEntity *rootEntity = nullptr;
+    {
+        GEO3D_TRACE_SCOPE("viewer", "createScene");
+        rootEntity = Geo3DSceneBuilder::createScene(m_objectSet, m_layerFilter, view->camera(), false);
+    }
+    m_sceneRoot = rootEntity;
+
+    // Entities of objects that are removed or regenerated are recycled
+    m_objectSet->setEntityPool(m_entityPool);
+    m_entityPool->reserve(rootEntity, s_entityPoolReserve);
+
+    m_loader = new Geo3DProgressiveLoader(m_objectSet, this);
+    connect(m_loader, &Geo3DProgressiveLoader::finished, this, [this, loader = m_loader.data()]() {
+        // A start is warm when every generated mesh came from the tessellation cache
+        const Geo3DTessellationCache::Statistics cacheStats = m_tessellationCache->statistics();
+        const int cachedMeshes = cacheStats.hits;
+        const int generatedMeshes = cacheStats.misses;
+        qDebug() << (generatedMeshes == 0 && cachedMeshes > 0 ? "Warm start:" : "Cold start:")
+                 << loader->upgradedCount() << "objects at full detail after" << loader->elapsedMs() << "ms -"
+                 << cachedMeshes << "meshes from cache," << generatedMeshes << "tessellated";
+    });
+    m_loader->start(rootEntity);
+    qDebug() << "Proxy scene of" << m_loader->totalCount() << "objects built in" << openTimer.elapsed() << "ms";
+
+    // Time to interactive: the first frame with the proxy scene on screen
+    Qt3DRender::QRenderCapture* capture =
+        new Qt3DRender::QRenderCapture(m_layerFilter->findChild<Qt3DRender::QFrustumCulling*>());
+    Qt3DRender::QRenderCaptureReply* firstFrame = capture->requestCapture();
+    const qint64 startupMs = m_startupTimer.elapsed() - openTimer.elapsed();
+    connect(firstFrame, &Qt3DRender::QRenderCaptureReply::completed, this,
+            [capture, firstFrame, openTimer, startupMs]() {
+                const qint64 interactiveMs = openTimer.elapsed();
+                qInfo() << "Time to interactive:" << interactiveMs << "ms after opening the view,"
+                        << startupMs + interactiveMs << "ms after startup";
+                firstFrame->deleteLater();
+                capture->deleteLater();
+            });
+
+    QVector3D minBound, maxBound;
+    Geo3DSceneBuilder::sceneBounds(m_objectSet, minBound, maxBound);
     qDebug() << "Scene bounds - Min:" << minBound << "Max:" << maxBound;
-    qDebug() << "Scene center:" << center;
-    qDebug() << "Scene size:" << sceneSize;
-    qDebug() << "Camera distance:" << cameraDistance;
+    qDebug() << "Camera position:" << view->camera()->position();
 
     // Camera controller
     Qt3DExtras::QOrbitCameraController *camController = new Qt3DExtras::QOrbitCameraController(rootEntity);
-    camController->setCamera(cameraEntity);
-
-    // Light - position it relative to scene
-    Qt3DCore::QEntity *lightEntity = new Qt3DCore::QEntity(rootEntity);
-    Qt3DRender::QPointLight *light = new Qt3DRender::QPointLight(lightEntity);
-    light->setColor("white");
-    light->setIntensity(1.5f);
-    lightEntity->addComponent(light);
-    Qt3DCore::QTransform *lightTransform = new Qt3DCore::QTransform(lightEntity);
-    lightTransform->setTranslation(center + QVector3D(maxDimension, maxDimension, maxDimension));
-    lightEntity->addComponent(lightTransform);
+    camController->setCamera(view->camera());
+
+    // Camera path recording and replay; the recorder goes away with the scene
+    m_cameraRecorder = new Geo3DCameraRecorder(rootEntity, view->camera(), this);
+
+    // Performance overlay of the current scene
+    m_performanceMonitor = new Geo3DPerformanceMonitor(m_objectSet, rootEntity, this);
+    connect(m_performanceMonitor, &Geo3DPerformanceMonitor::statisticsUpdated, m_performanceLabel,
+            [label = m_performanceLabel](const Geo3DPerformanceMonitor::Statistics& statistics) {
+                label->setText(Geo3DPerformanceMonitor::formatStatistics(statistics));
+            });
+    m_performanceMonitor->setEnabled(m_performanceButton && m_performanceButton->isChecked());
 
     // Set root entity
     view->setRootEntity(rootEntity);
     view->show();
+    view->requestActivate();
+}
+
+Qt3DExtras::Qt3DWindow* Qt3DViewer::ensureView()
+{
+    if (m_view) {
+        return m_view;
+    }
+
+    // Create Qt3D window
+    m_view = new Qt3DExtras::Qt3DWindow();
+    m_view->setActiveFrameGraph(Geo3DSceneBuilder::createFrameGraph(m_view, m_view->camera(), &m_layerFilter));
+
+    // Closing only hides the window, so the next show reuses it
+    m_view->installEventFilter(this);
+    return m_view;
+}
+
+void Qt3DViewer::releaseScene()
+{
+    if (!m_sceneRoot) {
+        return;
+    }
+    GEO3D_TRACE_SCOPE("viewer", "releaseScene");
+
+    // Helpers that refer to the entities go first; the loader waits for its
+    // background tessellation and leaves the remaining proxies alone
+    delete m_loader.data();
+    delete m_cameraRecorder.data();
+    if (m_recordButton) {
+        m_recordButton->setChecked(false);
+    }
+    delete m_performanceMonitor.data();
+
+    // Object entities, layers and shared nodes, then the rest of the scene;
+    // pooled bundles would not survive it either
+    if (m_objectSet) {
+        m_objectSet->releaseEntities();
+    }
+    m_entityPool->clear();
+    if (m_view) {
+        m_view->setRootEntity(nullptr);
+    }
+    delete m_sceneRoot;
+    m_sceneRoot = nullptr;
+}
+
+bool Qt3DViewer::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_view && event->type() == QEvent::Close) {
+        // Keep the window and its framegraph; drop the scene to free its memory
+        event->ignore();
+        m_view->hide();
+        releaseScene();
+        return true;
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+bool Qt3DViewer::startCameraRecording()
+{
+    if (!m_cameraRecorder) {
+        qWarning() << "Open the 3D view before recording a camera path";
+        return false;
+    }
+
+    m_cameraRecorder->startRecording();
+    return true;
+}
+
+bool Qt3DViewer::stopCameraRecording(const QString& filePath)
+{
+    if (!m_cameraRecorder || !m_cameraRecorder->isRecording()) {
+        return false;
+    }
+
+    const Geo3DCameraPath path = m_cameraRecorder->stopRecording();
+    if (!path.saveToFile(filePath)) {
+        return false;
+    }
+
+    qDebug() << "Recorded" << path.count() << "frames over" << path.durationMs() << "ms to" << filePath;
+    return true;
+}
+
+bool Qt3DViewer::replayCameraPath(const QString& filePath, const QString& timingsPath)
+{
+    if (!m_cameraRecorder) {
+        qWarning() << "Open the 3D view before replaying a camera path";
+        return false;
+    }
+
+    Geo3DCameraPath path;
+    if (!path.loadFromFile(filePath)) {
+        return false;
+    }
+
+    const QString outputPath = timingsPath.isEmpty() ? filePath + QStringLiteral(".timings.json") : timingsPath;
+    Geo3DCameraRecorder* recorder = m_cameraRecorder;
+    disconnect(recorder, &Geo3DCameraRecorder::replayFinished, this, nullptr);
+    connect(recorder, &Geo3DCameraRecorder::replayFinished, this, [recorder, outputPath]() {
+        const QVector<double> frameTimes = recorder->frameTimes();
+        qDebug().noquote() << "Camera path replay:"
+                           << QJsonDocument(Geo3DCameraRecorder::summarizeFrameTimes(frameTimes)).toJson(QJsonDocument::Compact);
+        Geo3DCameraRecorder::saveFrameTimes(outputPath, frameTimes);
+    });
+
+    recorder->startReplay(path);
+    return true;
+}
+
+void Qt3DViewer::toggleCameraRecording(bool record)
+{
+    if (record) {
+        if (!startCameraRecording()) {
+            m_recordButton->setChecked(false);
+        }
+        return;
+    }
+
+    if (!m_cameraRecorder || !m_cameraRecorder->isRecording()) {
+        return;
+    }
+
+    const QString filePath = QFileDialog::getSaveFileName(this, "Save Camera Path", QString(),
+                                                          "Camera paths (*.json)");
+    if (filePath.isEmpty()) {
+        m_cameraRecorder->stop();
+        return;
+    }
+    stopCameraRecording(filePath);
+}
+
+void Qt3DViewer::togglePerformancePanel(bool show)
+{
+    m_performanceLabel->setVisible(show);
+    if (!show) {
+        m_performanceLabel->clear();
+    }
+    if (m_performanceMonitor) {
+        m_performanceMonitor->setEnabled(show);
+    } else if (show) {
+        m_performanceLabel->setText("Open the 3D view to collect statistics.");
+    }
+}
+
+void Qt3DViewer::showMemoryReport()
+{
+    if (!m_objectSet) {
+        QMessageBox::information(this, "Memory Usage", "No objects loaded.");
+        return;
+    }
+
+    const Geo3DObjectSet::MemoryReport report = m_objectSet->memoryReport();
+    qDebug().noquote() << "Memory usage:" << QJsonDocument(report.toJson()).toJson(QJsonDocument::Compact);
+    QMessageBox::information(this, "Memory Usage", formatMemoryReport(report));
+}
+
+void Qt3DViewer::chooseCameraPathToReplay()
+{
+    const QString filePath = QFileDialog::getOpenFileName(this, "Replay Camera Path", QString(),
+                                                          "Camera paths (*.json)");
+    if (!filePath.isEmpty()) {
+        replayCameraPath(filePath);
+    }
 }
 
 void Qt3DViewer::setupUI()
@@ -137,7 +497,9 @@ void Qt3DViewer::setupUI()
         "• Real-time 3D rendering of multiple objects\n"
         "• Mouse controls (orbit, zoom, pan)\n"
         "• Support for any Geo3DObject subclasses\n"
-        "• Automatic demo mode if no object set is provided"
+        "• Automatic demo mode if no object set is provided\n"
+        "• Camera path recording and replay with frame timings\n"
+        "• Performance panel with frame times, triangles and geometry memory"
         );
     info->setWordWrap(true);
     info->setStyleSheet("padding: 15px; background-color: #f0f0f0;");
@@ -149,69 +511,32 @@ void Qt3DViewer::setupUI()
     connect(showButton, &QPushButton::clicked, this, &Qt3DViewer::showObjects);
     layout->addWidget(showButton);
 
-    QPushButton* exitButton = new QPushButton("Exit");
-    connect(exitButton, &QPushButton::clicked, this, &QWidget::close);
-    layout->addWidget(exitButton);
+    m_recordButton = new QPushButton("Record Camera Path");
+    m_recordButton->setCheckable(true);
+    connect(m_recordButton, &QPushButton::toggled, this, &Qt3DViewer::toggleCameraRecording);
+    layout->addWidget(m_recordButton);
 
-    layout->addStretch();
-}
+    QPushButton* replayButton = new QPushButton("Replay Camera Path...");
+    connect(replayButton, &QPushButton::clicked, this, &Qt3DViewer::chooseCameraPathToReplay);
+    layout->addWidget(replayButton);
 
-void Qt3DViewer::calculateSceneBounds(QVector3D& minBound, QVector3D& maxBound, QVector3D& center)
-{
-    if (!m_objectSet || m_objectSet->isEmpty()) {
-        minBound = QVector3D(-5, -5, -5);
-        maxBound = QVector3D(5, 5, 5);
-        center = QVector3D(0, 0, 0);
-        return;
-    }
+    QPushButton* memoryButton = new QPushButton("Memory Usage...");
+    connect(memoryButton, &QPushButton::clicked, this, &Qt3DViewer::showMemoryReport);
+    layout->addWidget(memoryButton);
 
-    bool firstObject = true;
-    minBound = QVector3D(0, 0, 0);
-    maxBound = QVector3D(0, 0, 0);
-
-    // Iterate through all objects
-    for (auto it = m_objectSet->constBegin(); it != m_objectSet->constEnd(); ++it) {
-        Geo3DObject* obj = it.value();
-        if (!obj) continue;
-
-        QVector3D pos = obj->getPosition();
-        QVector3D scale = obj->getScale();
-
-        // Estimate object bounds based on type
-        float objRadius = 0.0f;
-        float objHeight = 0.0f;
-
-        // Try to cast to different object types to get dimensions
-        if (CylinderObject* cyl = dynamic_cast<CylinderObject*>(obj)) {
-            objRadius = cyl->getRadius() * qMax(scale.x(), scale.z());
-            objHeight = cyl->getLength() * scale.y();
-        } else if (TubeObject* tube = dynamic_cast<TubeObject*>(obj)) {
-            objRadius = tube->getOuterRadius() * qMax(scale.x(), scale.z());
-            objHeight = tube->getHeight() * scale.y();
-        } else {
-            // Default bounds for unknown objects
-            objRadius = 1.0f * qMax(scale.x(), scale.z());
-            objHeight = 2.0f * scale.y();
-        }
+    m_performanceButton = new QPushButton("Performance Panel");
+    m_performanceButton->setCheckable(true);
+    connect(m_performanceButton, &QPushButton::toggled, this, &Qt3DViewer::togglePerformancePanel);
+    layout->addWidget(m_performanceButton);
 
-        // Calculate object's bounding box
-        QVector3D objMin = pos - QVector3D(objRadius, objHeight/2, objRadius);
-        QVector3D objMax = pos + QVector3D(objRadius, objHeight/2, objRadius);
-
-        if (firstObject) {
-            minBound = objMin;
-            maxBound = objMax;
-            firstObject = false;
-        } else {
-            minBound.setX(qMin(minBound.x(), objMin.x()));
-            minBound.setY(qMin(minBound.y(), objMin.y()));
-            minBound.setZ(qMin(minBound.z(), objMin.z()));
-
-            maxBound.setX(qMax(maxBound.x(), objMax.x()));
-            maxBound.setY(qMax(maxBound.y(), objMax.y()));
-            maxBound.setZ(qMax(maxBound.z(), objMax.z()));
-        }
-    }
+    m_performanceLabel = new QLabel();
+    m_performanceLabel->setStyleSheet("font-family: monospace; padding: 10px; background-color: #202020; color: #e0e0e0;");
+    m_performanceLabel->setVisible(false);
+    layout->addWidget(m_performanceLabel);
 
-    center = (minBound + maxBound) / 2.0f;
+    QPushButton* exitButton = new QPushButton("Exit");
+    connect(exitButton, &QPushButton::clicked, this, &QWidget::close);
+    layout->addWidget(exitButton);
+
+    layout->addStretch();
 }
@@ -2,14 +2,32 @@
 #define QT3DVIEWER_H
 
 #include <QWidget>
+#include <QPointer>
+#include <QElapsedTimer>
 
 QT_BEGIN_NAMESPACE
 class QVBoxLayout;
 class QPushButton;
 class QLabel;
+class QFileSystemWatcher;
+class QTimer;
+namespace Qt3DCore {
+class QEntity;
+}
+namespace Qt3DRender {
+class QLayerFilter;
+}
+namespace Qt3DExtras {
+class Qt3DWindow;
+}
 QT_END_NAMESPACE
 
 class Geo3DObjectSet;
+class Geo3DTessellationCache;
+class Geo3DEntityPool;
+class Geo3DCameraRecorder;
+class Geo3DPerformanceMonitor;
+class Geo3DProgressiveLoader;
 
 class Qt3DViewer : public QWidget
 {
@@ -17,29 +35,131 @@ class Qt3DViewer : public QWidget
 
 public:
     explicit Qt3DViewer(QWidget* parent = nullptr);
+    ~Qt3DViewer();
 
     /**
      * @brief Sets the object set to be rendered
+     *
+     * A set passed in here stays owned by the caller. Sets the viewer creates
+     * itself, with openSceneFile() or as the demo scene, are owned by the
+     * viewer. Any such set is deleted when it is replaced through this call
+     * or when the viewer is destroyed.
+     *
      * @param objectSet Pointer to the Geo3DObjectSet to display
      * @note The viewer does not take ownership of the object set
      */
     void setObjectSet(Geo3DObjectSet* objectSet);
 
+    /**
+     * @brief Loads a scene file and opens the 3D view right away
+     *
+     * The view shows bounding-box proxies first and full meshes as they are
+     * tessellated. The time to the first rendered frame is logged, from the
+     * construction of the viewer and from opening the view. The file is
+     * watched for changes afterwards.
+     *
+     * @param filePath Scene file in any format supported by Geo3DObjectSet::loadFromFile()
+     * @return false if the file could not be loaded
+     * @note The viewer owns the loaded object set
+     */
+    bool openSceneFile(const QString& filePath);
+
     /**
      * @brief Gets the currently assigned object set
      * @return Pointer to the current object set, or nullptr if none is set
      */
     Geo3DObjectSet* getObjectSet() const;
 
+    /**
+     * @brief Watches a scene file and applies its changes to the object set
+     *
+     * Whenever the file is rewritten, the object set is updated with
+     * Geo3DObjectSet::reloadFromFile(), so only added, removed and modified
+     * objects touch the displayed entities. Bursts of change notifications
+     * are coalesced into one reload.
+     *
+     * @param filePath Scene file the current object set was loaded from or saved to
+     */
+    void watchSceneFile(const QString& filePath);
+
+    /**
+     * @brief Starts recording the camera of the 3D window, one pose per frame
+     *
+     * @return false if no 3D window is open
+     */
+    bool startCameraRecording();
+
+    /**
+     * @brief Stops recording and saves the camera path
+     *
+     * @param filePath Path to the camera path file
+     * @return true if a recording was running and the file was written
+     */
+    bool stopCameraRecording(const QString& filePath);
+
+    /**
+     * @brief Replays a recorded camera path in the 3D window
+     *
+     * The path is replayed one keyframe per frame, so every replay renders the
+     * same views. When it finishes, the frame time summary is logged and every
+     * frame time is written to timingsPath.
+     *
+     * @param filePath Path to a camera path file
+     * @param timingsPath Output file for the frame times; empty for filePath + ".timings.json"
+     * @return false if no 3D window is open or the path could not be read
+     */
+    bool replayCameraPath(const QString& filePath, const QString& timingsPath = QString());
+
 private slots:
     void showObjects();
+    void onSceneFileChanged(const QString& filePath);
+    void reloadSceneFile();
+    void toggleCameraRecording(bool record);
+    void chooseCameraPathToReplay();
+    void togglePerformancePanel(bool show);
+    void showMemoryReport();
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 private:
     void setupUI();
 
-    void calculateSceneBounds(QVector3D& minBound, QVector3D& maxBound, QVector3D& center);
+    // Creates the 3D window and its framegraph on first use
+    Qt3DExtras::Qt3DWindow* ensureView();
+
+    // Deletes the displayed scene and everything attached to it; the window stays
+    void releaseScene();
 
     Geo3DObjectSet* m_objectSet;
+    bool m_ownsObjectSet;
+    QFileSystemWatcher* m_fileWatcher;
+    QTimer* m_reloadTimer;
+    QString m_sceneFilePath;
+    Geo3DTessellationCache* m_tessellationCache;
+
+    // Recycles entity bundles within the displayed scene
+    Geo3DEntityPool* m_entityPool;
+
+    // The one 3D window, reused by every "Show 3D Objects", and its current scene
+    Qt3DExtras::Qt3DWindow* m_view;
+    Qt3DRender::QLayerFilter* m_layerFilter;
+    Qt3DCore::QEntity* m_sceneRoot;
+
+    // Recorder attached to the displayed scene
+    QPointer<Geo3DCameraRecorder> m_cameraRecorder;
+    QPushButton* m_recordButton;
+
+    // Overlay statistics of the displayed scene; sampled only while the panel is shown
+    QPointer<Geo3DPerformanceMonitor> m_performanceMonitor;
+    QPushButton* m_performanceButton;
+    QLabel* m_performanceLabel;
+
+    // Replaces the proxies of the displayed scene with full meshes
+    QPointer<Geo3DProgressiveLoader> m_loader;
+
+    // Started with the viewer, to report time to interactive from startup
+    QElapsedTimer m_startupTimer;
 };
 
 #endif // QT3DVIEWER_H
@@ -0,0 +1,10 @@
+QT -= gui widgets
+
+CONFIG += console
+CONFIG -= app_bundle
+
+include(../../geo3d.pri)
+
+TARGET = geo3d_scenegen
+
+SOURCES += main.cpp
@@ -1,8 +1,6 @@
 #include "tubeobject.h"
+#include "geo3dtrace.h"
 
-#include <Qt3DCore/QGeometry>
-#include <Qt3DCore/QBuffer>
-#include <Qt3DCore/QAttribute>
 #include <Qt3DRender/QGeometryRenderer>
 #include <QJsonObject>
 #include <QtMath>
@@ -155,13 +153,50 @@ void TubeObject::setTessellation(int rings, int slices)
 int TubeObject::getTriangleCount() const
 {
     // Outer surface + Inner surface + Top ring + Bottom ring
-    return 2 * m_slices * m_rings + 2 * m_slices * 2;
+    return 2 * m_slices * m_rings * 2 + 2 * m_slices * 2;
+}
+
+Geo3DObject::MemoryUsage TubeObject::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    usage.parameterBytes = sizeof(TubeObject);
+    return usage;
+}
+
+bool TubeObject::isClosedSurface() const
+{
+    return true;
+}
+
+bool TubeObject::getLocalBounds(QVector3D& minimum, QVector3D& maximum) const
+{
+    const float halfHeight = m_height / 2.0f;
+    minimum = QVector3D(-m_outerRadius, -halfHeight, -m_outerRadius);
+    maximum = QVector3D(m_outerRadius, halfHeight, m_outerRadius);
+    return true;
+}
+
+QByteArray TubeObject::getShapeKey() const
+{
+    QByteArray key = getObjectType().toLatin1();
+    key.append(reinterpret_cast<const char*>(&m_innerRadius), sizeof(m_innerRadius));
+    key.append(reinterpret_cast<const char*>(&m_outerRadius), sizeof(m_outerRadius));
+    key.append(reinterpret_cast<const char*>(&m_height), sizeof(m_height));
+    key.append(reinterpret_cast<const char*>(&m_rings), sizeof(m_rings));
+    key.append(reinterpret_cast<const char*>(&m_slices), sizeof(m_slices));
+    return key;
 }
 
 Qt3DRender::QGeometryRenderer* TubeObject::createGeometry()
 {
-    Qt3DCore::QGeometry* geometry = new Qt3DCore::QGeometry();
+    GEO3D_TRACE_SCOPE("tessellation", "TubeObject::createGeometry");
+    MeshData mesh;
+    generateMesh(mesh);
+    return createGeometryFromMesh(mesh);
+}
 
+bool TubeObject::generateMesh(MeshData& mesh) const
+{
     // Calculate vertex count
     // We need vertices for: outer surface, inner surface, top ring, bottom ring
     int vertexCount = (m_rings + 1) * (m_slices + 1) * 2  // Outer and inner surfaces
@@ -335,11 +370,6 @@ Qt3DRender::QGeometryRenderer* TubeObject::createGeometry()
         indices.append(innerCurrent);
     }
 
-    // Create vertex buffer
-    Qt3DCore::QBuffer* vertexBuffer = new Qt3DCore::QBuffer(geometry);
-    vertexBuffer->setData(vertexBufferData);
-
-    // Create index buffer
     QByteArray indexBufferData;
     indexBufferData.resize(indices.size() * sizeof(unsigned int));
     unsigned int* indexPtr = reinterpret_cast<unsigned int*>(indexBufferData.data());
@@ -347,50 +377,22 @@ Qt3DRender::QGeometryRenderer* TubeObject::createGeometry()
         *indexPtr++ = index;
     }
 
-    Qt3DCore::QBuffer* indexBuffer = new Qt3DCore::QBuffer(geometry);
-    indexBuffer->setData(indexBufferData);
-
-    // Position attribute
-    Qt3DCore::QAttribute* positionAttribute = new Qt3DCore::QAttribute(geometry);
-    positionAttribute->setName(Qt3DCore::QAttribute::defaultPositionAttributeName());
-    positionAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
-    positionAttribute->setVertexSize(3);
-    positionAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
-    positionAttribute->setBuffer(vertexBuffer);
-    positionAttribute->setByteStride(6 * sizeof(float));
-    positionAttribute->setCount(vertexIndex);
-    geometry->addAttribute(positionAttribute);
-
-    // Normal attribute
-    Qt3DCore::QAttribute* normalAttribute = new Qt3DCore::QAttribute(geometry);
-    normalAttribute->setName(Qt3DCore::QAttribute::defaultNormalAttributeName());
-    normalAttribute->setVertexBaseType(Qt3DCore::QAttribute::Float);
-    normalAttribute->setVertexSize(3);
-    normalAttribute->setAttributeType(Qt3DCore::QAttribute::VertexAttribute);
-    normalAttribute->setBuffer(vertexBuffer);
-    normalAttribute->setByteStride(6 * sizeof(float));
-    normalAttribute->setByteOffset(3 * sizeof(float));
-    normalAttribute->setCount(vertexIndex);
-    geometry->addAttribute(normalAttribute);
-
-    // Index attribute
-    Qt3DCore::QAttribute* indexAttribute = new Qt3DCore::QAttribute(geometry);
-    indexAttribute->setAttributeType(Qt3DCore::QAttribute::IndexAttribute);
-    indexAttribute->setVertexBaseType(Qt3DCore::QAttribute::UnsignedInt);
-    indexAttribute->setBuffer(indexBuffer);
-    indexAttribute->setCount(indices.size());
-    geometry->addAttribute(indexAttribute);
-
-    Qt3DRender::QGeometryRenderer* renderer = new Qt3DRender::QGeometryRenderer();
-    renderer->setGeometry(geometry);
-    renderer->setPrimitiveType(Qt3DRender::QGeometryRenderer::Triangles);
-
-    return renderer;
+    mesh.vertices = vertexBufferData;
+    mesh.indices = indexBufferData;
+    mesh.vertexCount = vertexIndex;
+    mesh.indexCount = indices.size();
+    mesh.hasNormals = true;
+    return true;
+}
+
+bool TubeObject::hasGeneratedMesh() const
+{
+    return true;
 }
 
 void TubeObject::recreateGeometryIfNeeded()
 {
-    // Placeholder - same concept as CylinderObject
+    invalidateGeometry();
 }
 
 QJsonObject TubeObject::toJson() const
@@ -423,6 +425,7 @@ QJsonObject TubeObject::toJson() const
 
     json["visible"] = isVisible();
     json["opacity"] = getOpacity();
+    renderModesToJson(json);
 
     // Tube properties
     QJsonObject tube;
@@ -487,6 +490,8 @@ bool TubeObject::fromJson(const QJsonObject& json)
         setOpacity(json["opacity"].toDouble());
     }
 
+    renderModesFromJson(json);
+
     // Load tube properties
     if (json.contains("tube")) {
         QJsonObject tube = json["tube"].toObject();
@@ -505,3 +510,8 @@ QString TubeObject::getObjectType() const
 {
     return "Tube";
 }
+
+Geo3DObject* TubeObject::clone() const
+{
+    return new TubeObject(*this);
+}
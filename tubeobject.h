@@ -70,14 +70,34 @@ public:
     void setDimensions(float innerRadius, float outerRadius, float height);
     void setTessellation(int rings, int slices);
 
-    int getTriangleCount() const;
+    // Exact size of the mesh from generateMesh()
+    int getTriangleCount() const override;
+
+    // Size of the object; all shape parameters are stored inline
+    MemoryUsage getMemoryUsage() const override;
+
+    // Outer, inner and both annular caps enclose the tube wall
+    bool isClosedSurface() const override;
+
+    // Centered at the origin with its axis along Y, enclosed by the outer radius
+    bool getLocalBounds(QVector3D& minimum, QVector3D& maximum) const override;
+
+    // Radii, height and tessellation; tubes with equal parameters share one mesh
+    QByteArray getShapeKey() const override;
+
+    // Interleaved positions and normals for the walls and both annular caps
+    bool generateMesh(MeshData& mesh) const override;
+    bool hasGeneratedMesh() const override;
 
     // JSON Serialization
     QJsonObject toJson() const override;
     bool fromJson(const QJsonObject& json) override;
     QString getObjectType() const override;
+    Geo3DObject* clone() const override;
 
 protected:
+    TubeObject(const TubeObject& other) = default;
+
     Qt3DRender::QGeometryRenderer* createGeometry() override;
 
 private: